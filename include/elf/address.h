@@ -0,0 +1,37 @@
+#ifndef ELF_ADDRESS_H
+#define ELF_ADDRESS_H
+
+#include "reader.h"
+
+namespace elf {
+    struct AddressRange {
+        Elf64_Addr address;
+        Elf64_Xword size;
+        std::string name;
+    };
+
+    // ranges sorted by address for binary search, built once and then read-only
+    class AddressMap {
+    public:
+        AddressMap() = default;
+        explicit AddressMap(std::vector<AddressRange> ranges);
+
+    public:
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] const std::vector<AddressRange> &ranges() const;
+        [[nodiscard]] const AddressRange *find(Elf64_Addr address) const;
+
+    public:
+        void insert(std::vector<AddressRange> ranges);
+
+    private:
+        std::vector<AddressRange> mRanges;
+        // highest end among the ranges up to each index, bounds the walk back to an enclosing range
+        std::vector<Elf64_Addr> mReach;
+    };
+
+    // demangled names are resolved for the whole table up front, in parallel
+    std::vector<AddressRange> symbolRanges(const Reader &reader, bool demangle = false);
+}
+
+#endif //ELF_ADDRESS_H
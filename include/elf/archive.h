@@ -0,0 +1,47 @@
+#ifndef ELF_ARCHIVE_H
+#define ELF_ARCHIVE_H
+
+#include "reader.h"
+#include <map>
+#include <thread>
+
+namespace elf {
+    struct ArchiveMember {
+        std::string name;
+        Elf64_Off header;
+        Elf64_Off offset;
+        Elf64_Xword size;
+    };
+
+    // members of an ar archive, each readable in place from the archive's mapping
+    class Archive {
+    public:
+        Archive(
+                std::shared_ptr<void> buffer,
+                std::vector<ArchiveMember> members,
+                std::map<std::string, size_t, std::less<>> symbols
+        );
+
+    public:
+        [[nodiscard]] const std::vector<ArchiveMember> &members() const;
+        [[nodiscard]] const std::map<std::string, size_t, std::less<>> &symbols() const;
+        [[nodiscard]] std::optional<size_t> find(std::string_view symbol) const;
+        [[nodiscard]] tl::expected<Reader, std::error_code> reader(size_t index) const;
+
+    public:
+        // opens every member concurrently with warmed tables, adding their defined symbols to the index
+        std::vector<tl::expected<Reader, std::error_code>> index(
+                size_t concurrency = std::thread::hardware_concurrency()
+        );
+
+    private:
+        std::shared_ptr<void> mBuffer;
+        std::vector<ArchiveMember> mMembers;
+        std::map<std::string, size_t, std::less<>> mSymbols;
+    };
+
+    tl::expected<Archive, std::error_code> openArchive(const std::filesystem::path &path);
+    tl::expected<Archive, std::error_code> openArchive(std::shared_ptr<void> buffer, size_t length);
+}
+
+#endif //ELF_ARCHIVE_H
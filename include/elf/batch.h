@@ -0,0 +1,28 @@
+#ifndef ELF_BATCH_H
+#define ELF_BATCH_H
+
+#include "reader.h"
+#include <future>
+#include <functional>
+
+namespace elf {
+    using OpenResult = tl::expected<Reader, std::error_code>;
+    using OpenCallback = std::function<void(size_t index, OpenResult result)>;
+
+    // dropping the batch waits for the files still in flight
+    struct OpenBatch {
+        std::vector<std::future<OpenResult>> futures;
+        std::future<void> worker;
+    };
+
+    // keeps up to depth files in flight, stat, open and the header read go through io_uring when the kernel allows it.
+    // headers are validated from the prefetched bytes before mapping, so broken files never fault a page in.
+    // callbacks run one at a time in completion order, the call returns once every path has been delivered.
+    // an exception thrown by the callback stops the batch and is rethrown once nothing is left in flight.
+    void openFiles(const std::vector<std::filesystem::path> &paths, const OpenCallback &callback, size_t depth = 64);
+
+    // same as above on a background thread, each future completes as soon as its file does
+    OpenBatch openFiles(std::vector<std::filesystem::path> paths, size_t depth = 64);
+}
+
+#endif //ELF_BATCH_H
@@ -0,0 +1,26 @@
+#ifndef ELF_BLOAT_H
+#define ELF_BLOAT_H
+
+#include "reader.h"
+
+namespace elf {
+    struct SizeEntry {
+        std::string name;
+        Elf64_Xword fileSize;
+        Elf64_Xword vmSize;
+    };
+
+    // every level partitions the same bytes, so each sums to the same totals
+    struct SizeReport {
+        std::vector<SizeEntry> segments;
+        std::vector<SizeEntry> sections;
+        std::vector<SizeEntry> symbols;
+        std::vector<SizeEntry> units;
+        std::vector<SizeEntry> prefixes;
+    };
+
+    // assigns each allocated byte to one symbol or to padding, compile units are inferred from STT_FILE groups
+    SizeReport sizeReport(const Reader &reader, const std::vector<std::string> &prefixes = {});
+}
+
+#endif //ELF_BLOAT_H
@@ -0,0 +1,36 @@
+#ifndef ELF_CACHE_H
+#define ELF_CACHE_H
+
+#include "reader.h"
+#include <map>
+#include <mutex>
+#include <sys/stat.h>
+
+namespace elf {
+    // one mapping per (device, inode), replaced once size or mtime change.
+    // files sharing a build-ID stay apart, a stripped binary and its debug file are different mappings.
+    class ReaderCache {
+    private:
+        struct Entry {
+            Reader reader;
+            off_t size;
+            timespec modified;
+        };
+
+    public:
+        tl::expected<Reader, std::error_code> open(const std::filesystem::path &path);
+
+    public:
+        void erase(const std::filesystem::path &path);
+        void clear();
+
+    private:
+        std::mutex mMutex;
+        std::map<std::pair<dev_t, ino_t>, Entry> mInodes;
+    };
+
+    ReaderCache &readerCache();
+    tl::expected<Reader, std::error_code> openCachedFile(const std::filesystem::path &path);
+}
+
+#endif //ELF_CACHE_H
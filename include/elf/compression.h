@@ -0,0 +1,59 @@
+#ifndef ELF_COMPRESSION_H
+#define ELF_COMPRESSION_H
+
+#include "reader.h"
+#include <list>
+#include <mutex>
+#include <future>
+#include <unordered_map>
+
+namespace elf {
+    struct Buffer {
+        std::shared_ptr<const void> owner;
+        const std::byte *data;
+        Elf64_Xword size;
+    };
+
+    // decompressed SHF_COMPRESSED sections keyed by their mapped bytes, evicted in LRU order over budget.
+    // concurrent requests for the same section wait for a single decompression.
+    class DecompressionCache {
+    private:
+        using Result = tl::expected<std::shared_ptr<const std::vector<std::byte>>, std::error_code>;
+
+        struct Entry {
+            size_t id;
+            std::weak_ptr<void> owner;
+            std::shared_future<Result> future;
+            Elf64_Xword size;
+            std::list<const std::byte *>::iterator position;
+        };
+
+    public:
+        explicit DecompressionCache(size_t budget);
+
+    public:
+        tl::expected<Buffer, std::error_code> get(const Reader &reader, const std::shared_ptr<ISection> &section);
+
+    public:
+        size_t bytes();
+        void clear();
+
+    private:
+        void evict();
+
+    private:
+        size_t mBudget;
+        size_t mBytes;
+        size_t mGeneration;
+        std::mutex mMutex;
+        std::list<const std::byte *> mLRU;
+        std::unordered_map<const std::byte *, Entry> mEntries;
+    };
+
+    DecompressionCache &decompressionCache();
+
+    tl::expected<std::vector<std::byte>, std::error_code> decompress(const Reader &reader, ISection &section);
+    tl::expected<Buffer, std::error_code> sectionData(const Reader &reader, const std::shared_ptr<ISection> &section);
+}
+
+#endif //ELF_COMPRESSION_H
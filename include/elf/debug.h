@@ -0,0 +1,56 @@
+#ifndef ELF_DEBUG_H
+#define ELF_DEBUG_H
+
+#include "symbol.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace elf {
+    struct DebugSection {
+        Reader reader;
+        std::shared_ptr<ISection> section;
+    };
+
+    // a stripped binary and its separate debug file queried as one object, contents come from
+    // whichever file actually carries them
+    class DebugObject {
+    public:
+        DebugObject(Reader binary, std::optional<Reader> debug);
+
+    public:
+        [[nodiscard]] const Reader &binary() const;
+        [[nodiscard]] const std::optional<Reader> &debug() const;
+
+    public:
+        [[nodiscard]] std::optional<DebugSection> section(std::string_view name) const;
+        [[nodiscard]] std::vector<DebugSection> sections() const;
+        [[nodiscard]] std::optional<SymbolTable> symbols() const;
+
+    private:
+        Reader mBinary;
+        std::optional<Reader> mDebug;
+    };
+
+    // remembers where each module's debug file is, or that it has none. debug files are opened on demand, so
+    // none stays mapped after its last reader is dropped.
+    class DebugResolver {
+    public:
+        explicit DebugResolver(std::vector<std::filesystem::path> directories = {"/usr/lib/debug"});
+
+    public:
+        std::optional<Reader> resolve(const Reader &binary, const std::filesystem::path &path);
+        tl::expected<DebugObject, std::error_code> open(const std::filesystem::path &path);
+
+    private:
+        std::optional<std::pair<std::filesystem::path, Reader>> search(const Reader &binary, const std::filesystem::path &path);
+
+    private:
+        std::vector<std::filesystem::path> mDirectories;
+        std::mutex mMutex;
+        std::unordered_map<std::string, std::optional<std::filesystem::path>> mCache;
+    };
+
+    std::optional<std::pair<std::string, Elf64_Word>> debugLink(const Reader &reader);
+}
+
+#endif //ELF_DEBUG_H
@@ -0,0 +1,42 @@
+#ifndef ELF_DEMANGLE_H
+#define ELF_DEMANGLE_H
+
+#include "symbol.h"
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace elf {
+    // demangles each string table offset at most once, names live in an arena until the demangler is destroyed
+    class Demangler {
+    private:
+        struct Shard {
+            std::mutex mutex;
+            std::unordered_map<Elf64_Word, std::string_view> names;
+            std::vector<std::unique_ptr<char[]>> blocks;
+            char *block;
+            size_t used;
+        };
+
+    public:
+        explicit Demangler(SymbolTable table);
+
+    public:
+        std::string_view name(size_t index);
+        std::string_view name(const SymbolView &symbol);
+
+    public:
+        void demangle(size_t concurrency = std::thread::hardware_concurrency());
+
+    private:
+        std::string_view store(Shard &shard, std::string_view name);
+
+    private:
+        SymbolTable mTable;
+        std::unique_ptr<Shard[]> mShards;
+    };
+
+    std::optional<std::string> demangle(std::string_view name);
+}
+
+#endif //ELF_DEMANGLE_H
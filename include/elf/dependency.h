@@ -0,0 +1,65 @@
+#ifndef ELF_DEPENDENCY_H
+#define ELF_DEPENDENCY_H
+
+#include "reader.h"
+#include <thread>
+
+namespace elf {
+    struct Dependency {
+        std::string name;
+        std::filesystem::path path;
+        Reader reader;
+        std::optional<size_t> loader;
+        std::vector<size_t> needed;
+        std::vector<std::string> missing;
+    };
+
+    struct SymbolBinding {
+        size_t object;
+        std::string symbol;
+        std::string version;
+        bool weak;
+        std::optional<size_t> provider;
+    };
+
+    // objects in load order with the executable first, bindings in the order each object references them
+    struct DependencyGraph {
+        std::vector<Dependency> objects;
+        std::vector<SymbolBinding> bindings;
+    };
+
+    // follows DT_NEEDED the way the dynamic loader does, without running anything.
+    // paths are inside root, so images unpacked elsewhere resolve against their own directories.
+    class DependencyResolver {
+    public:
+        explicit DependencyResolver(
+                std::vector<std::filesystem::path> directories = {
+                        "/lib/x86_64-linux-gnu",
+                        "/usr/lib/x86_64-linux-gnu",
+                        "/lib/aarch64-linux-gnu",
+                        "/usr/lib/aarch64-linux-gnu",
+                        "/lib64",
+                        "/usr/lib64",
+                        "/lib",
+                        "/usr/lib"
+                },
+                std::filesystem::path root = "/"
+        );
+
+    public:
+        tl::expected<DependencyGraph, std::error_code> resolve(
+                const std::filesystem::path &path,
+                size_t concurrency = std::thread::hardware_concurrency()
+        ) const;
+
+    private:
+        // where path lives on the host, symlinks are followed inside root the way a chroot would see them
+        [[nodiscard]] tl::expected<std::filesystem::path, std::error_code> host(const std::filesystem::path &path) const;
+
+    private:
+        std::vector<std::filesystem::path> mDirectories;
+        std::filesystem::path mRoot;
+    };
+}
+
+#endif //ELF_DEPENDENCY_H
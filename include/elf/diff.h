@@ -0,0 +1,40 @@
+#ifndef ELF_DIFF_H
+#define ELF_DIFF_H
+
+#include "reader.h"
+#include <thread>
+
+namespace elf {
+    enum class ChangeType {
+        ADDED,
+        REMOVED,
+        MODIFIED
+    };
+
+    struct SectionChange {
+        std::string name;
+        ChangeType type;
+        Elf64_Xword oldSize;
+        Elf64_Xword newSize;
+        bool content;
+    };
+
+    struct SymbolChange {
+        std::string name;
+        unsigned char symbolType;
+        ChangeType type;
+        Elf64_Xword oldSize;
+        Elf64_Xword newSize;
+        bool content;
+    };
+
+    struct Diff {
+        std::vector<SectionChange> sections;
+        std::vector<SymbolChange> symbols;
+    };
+
+    // sections match by name and symbols by name and type, repeated keys pair up in table order
+    Diff diff(const Reader &before, const Reader &after, size_t concurrency = std::thread::hardware_concurrency());
+}
+
+#endif //ELF_DIFF_H
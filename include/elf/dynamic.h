@@ -0,0 +1,69 @@
+#ifndef ELF_DYNAMIC_H
+#define ELF_DYNAMIC_H
+
+#include "reader.h"
+
+namespace elf {
+    class IDynamic {
+    public:
+        virtual ~IDynamic() = default;
+
+    public:
+        virtual Elf64_Sxword tag() = 0;
+        virtual Elf64_Xword value() = 0;
+    };
+
+    template<typename T, endian::Type Endian>
+    class Dynamic : public IDynamic {
+    public:
+        explicit Dynamic(const T *dynamic);
+
+    public:
+        Elf64_Sxword tag() override;
+        Elf64_Xword value() override;
+
+    private:
+        T mDynamic;
+    };
+
+    class DynamicIterator {
+    public:
+        DynamicIterator(const std::byte *dynamic, size_t size, endian::Type endian);
+
+    public:
+        std::unique_ptr<IDynamic> operator*();
+        DynamicIterator &operator++();
+        DynamicIterator operator+(size_t offset);
+
+    public:
+        bool operator==(const DynamicIterator &rhs);
+        bool operator!=(const DynamicIterator &rhs);
+
+    private:
+        size_t mSize;
+        endian::Type mEndian;
+        const std::byte *mDynamic;
+    };
+
+    class DynamicTable {
+    public:
+        DynamicTable(Reader reader, std::shared_ptr<ISection> section);
+
+    public:
+        size_t size();
+        std::string string(Elf64_Xword index);
+
+    public:
+        std::unique_ptr<IDynamic> operator[](size_t index);
+
+    public:
+        DynamicIterator begin();
+        DynamicIterator end();
+
+    private:
+        Reader mReader;
+        std::shared_ptr<ISection> mSection;
+    };
+}
+
+#endif //ELF_DYNAMIC_H
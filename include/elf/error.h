@@ -8,7 +8,13 @@ namespace elf {
         INVALID_ELF_HEADER = 1,
         INVALID_ELF_MAGIC,
         INVALID_ELF_CLASS,
-        INVALID_ELF_ENDIAN
+        INVALID_ELF_ENDIAN,
+        INVALID_COMPRESSION_HEADER,
+        UNSUPPORTED_COMPRESSION,
+        DECOMPRESSION_FAILED,
+        INVALID_ARCHIVE_MAGIC,
+        INVALID_ARCHIVE_HEADER,
+        SECTION_OVERFLOW
     };
 
     class Category : public std::error_category {
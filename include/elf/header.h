@@ -4,6 +4,7 @@
 #include "endian.h"
 #include <elf.h>
 #include <cstddef>
+#include <type_traits>
 
 namespace elf {
     class IHeader {
@@ -23,10 +24,10 @@ namespace elf {
         virtual Elf64_Word flags() = 0;
         virtual Elf64_Half headerSize() = 0;
         virtual Elf64_Half segmentEntrySize() = 0;
-        virtual Elf64_Half segmentNum() = 0;
+        virtual Elf64_Word segmentNum() = 0;
         virtual Elf64_Half sectionEntrySize() = 0;
-        virtual Elf64_Half sectionNum() = 0;
-        virtual Elf64_Half sectionStrIndex() = 0;
+        virtual Elf64_Word sectionNum() = 0;
+        virtual Elf64_Word sectionStrIndex() = 0;
     };
 
     template<typename T, endian::Type Endian>
@@ -47,13 +48,20 @@ namespace elf {
         Elf64_Word flags() override;
         Elf64_Half headerSize() override;
         Elf64_Half segmentEntrySize() override;
-        Elf64_Half segmentNum() override;
+        Elf64_Word segmentNum() override;
         Elf64_Half sectionEntrySize() override;
-        Elf64_Half sectionNum() override;
-        Elf64_Half sectionStrIndex() override;
+        Elf64_Word sectionNum() override;
+        Elf64_Word sectionStrIndex() override;
 
     private:
-        const T *mHeader;
+        using Shdr = std::conditional_t<std::is_same_v<T, Elf64_Ehdr>, Elf64_Shdr, Elf32_Shdr>;
+
+        // section 0 carries the real counts once they overflow their header fields
+        Shdr initial();
+
+    private:
+        T mHeader;
+        const std::byte *mBuffer;
     };
 }
 
@@ -0,0 +1,53 @@
+#ifndef ELF_LAYOUT_H
+#define ELF_LAYOUT_H
+
+#include "reader.h"
+
+namespace elf {
+    // section and segment placement resolved once, lookups and translations are binary searches
+    class Layout {
+    private:
+        struct Interval {
+            Elf64_Off begin;
+            Elf64_Off end;
+            size_t index;
+        };
+
+        struct Load {
+            Elf64_Addr address;
+            Elf64_Off offset;
+            Elf64_Xword fileSize;
+        };
+
+    public:
+        explicit Layout(const Reader &reader);
+
+    public:
+        [[nodiscard]] const std::vector<size_t> &segments(size_t section) const;
+        [[nodiscard]] const std::vector<size_t> &sections(size_t segment) const;
+
+    public:
+        [[nodiscard]] std::optional<Elf64_Addr> address(Elf64_Off offset) const;
+        [[nodiscard]] std::optional<Elf64_Off> offset(Elf64_Addr address) const;
+
+    public:
+        [[nodiscard]] std::optional<size_t> segmentByAddress(Elf64_Addr address) const;
+        [[nodiscard]] std::optional<size_t> segmentByOffset(Elf64_Off offset) const;
+        [[nodiscard]] std::optional<size_t> sectionByAddress(Elf64_Addr address) const;
+        [[nodiscard]] std::optional<size_t> sectionByOffset(Elf64_Off offset) const;
+
+    private:
+        static std::optional<size_t> find(const std::vector<Interval> &intervals, Elf64_Off value);
+
+    private:
+        std::vector<std::vector<size_t>> mSegments;
+        std::vector<std::vector<size_t>> mSections;
+        std::vector<Load> mLoads;
+        std::vector<Interval> mLoadAddresses;
+        std::vector<Interval> mLoadOffsets;
+        std::vector<Interval> mSectionAddresses;
+        std::vector<Interval> mSectionOffsets;
+    };
+}
+
+#endif //ELF_LAYOUT_H
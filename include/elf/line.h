@@ -0,0 +1,84 @@
+#ifndef ELF_LINE_H
+#define ELF_LINE_H
+
+#include "compression.h"
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace elf {
+    struct Line {
+        Elf64_Addr address;
+        std::string_view file;
+        Elf64_Word line;
+        Elf64_Word column;
+    };
+
+    class LineTable {
+    private:
+        struct Row {
+            Elf64_Addr address;
+            Elf64_Word file;
+            Elf64_Word line;
+            Elf64_Word column;
+            bool end;
+        };
+
+        struct Program {
+            std::vector<Row> rows;
+            std::vector<std::string> files;
+        };
+
+        struct Unit {
+            Elf64_Off offset;
+            std::string directory;
+        };
+
+        struct Range {
+            Elf64_Addr begin;
+            Elf64_Addr end;
+            size_t unit;
+        };
+
+    public:
+        explicit LineTable(Reader reader);
+
+    public:
+        std::optional<Line> find(Elf64_Addr address);
+        // addresses may come in any order, results follow the order given
+        std::vector<std::optional<Line>> find(const std::vector<Elf64_Addr> &addresses);
+
+    private:
+        void index();
+        const Range *range(Elf64_Addr address);
+        const Program *program(size_t unit);
+
+    private:
+        static std::pair<std::vector<Row>::const_iterator, std::optional<Line>>
+        lookup(const Program &program, std::vector<Row>::const_iterator hint, Elf64_Addr address);
+
+    private:
+        [[nodiscard]] std::optional<Unit> unit(Elf64_Off offset, Elf64_Addr *low, Elf64_Addr *high) const;
+        [[nodiscard]] std::optional<Program> decode(const Unit &unit) const;
+        [[nodiscard]] std::pair<const std::byte *, Elf64_Xword> section(std::string_view name) const;
+
+    private:
+        Reader mReader;
+        endian::Type mEndian;
+        size_t mAddressSize;
+
+    private:
+        std::once_flag mIndexed;
+        std::map<std::string, Buffer, std::less<>> mBuffers;
+        std::vector<Unit> mUnits;
+        std::vector<Range> mRanges;
+
+    private:
+        std::shared_mutex mMutex;
+        std::unordered_map<size_t, Program> mPrograms;
+    };
+}
+
+#endif //ELF_LINE_H
@@ -0,0 +1,46 @@
+#ifndef ELF_MINIDEBUG_H
+#define ELF_MINIDEBUG_H
+
+#include "address.h"
+#include <mutex>
+#include <future>
+#include <unordered_map>
+
+namespace elf {
+    // inflated .gnu_debugdata images keyed by build id, or by mapping while it lives.
+    // each module is inflated once, concurrent requests wait for the first one. images are small, build id entries are
+    // kept until cleared and mapping entries are dropped once their mapping is gone.
+    class MiniDebugCache {
+    private:
+        struct Entry {
+            size_t id;
+            std::weak_ptr<void> owner;
+            std::shared_future<std::optional<Reader>> future;
+        };
+
+    public:
+        MiniDebugCache();
+
+    public:
+        std::optional<Reader> get(const Reader &reader);
+
+    public:
+        size_t size();
+        void clear();
+
+    private:
+        std::mutex mMutex;
+        size_t mGeneration;
+        std::unordered_map<std::string, Entry> mEntries;
+    };
+
+    MiniDebugCache &miniDebugCache();
+
+    tl::expected<Reader, std::error_code> openMiniDebugInfo(const Reader &reader);
+    std::optional<Reader> miniDebugInfo(const Reader &reader);
+
+    // symbols of stripped code, to be merged with the binary's own ranges
+    std::vector<AddressRange> miniDebugRanges(const Reader &reader, bool demangle = false);
+}
+
+#endif //ELF_MINIDEBUG_H
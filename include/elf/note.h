@@ -0,0 +1,83 @@
+#ifndef ELF_NOTE_H
+#define ELF_NOTE_H
+
+#include "reader.h"
+#include <string_view>
+
+namespace elf {
+    class INote {
+    public:
+        virtual ~INote() = default;
+
+    public:
+        virtual std::string_view name() = 0;
+        virtual const std::byte *descriptor() = 0;
+
+    public:
+        virtual Elf64_Word nameSize() = 0;
+        virtual Elf64_Word descriptorSize() = 0;
+        virtual Elf64_Word type() = 0;
+    };
+
+    template<endian::Type Endian>
+    class Note : public INote {
+    public:
+        Note(const Elf64_Nhdr *note, size_t align);
+
+    public:
+        std::string_view name() override;
+        const std::byte *descriptor() override;
+
+    public:
+        Elf64_Word nameSize() override;
+        Elf64_Word descriptorSize() override;
+        Elf64_Word type() override;
+
+    private:
+        size_t mAlign;
+        Elf64_Nhdr mHeader;
+        const Elf64_Nhdr *mNote;
+    };
+
+    class NoteIterator {
+    public:
+        NoteIterator(const std::byte *note, const std::byte *end, size_t align, endian::Type endian);
+
+    public:
+        std::unique_ptr<INote> operator*();
+        NoteIterator &operator++();
+
+    public:
+        bool operator==(const NoteIterator &rhs);
+        bool operator!=(const NoteIterator &rhs);
+
+    private:
+        [[nodiscard]] size_t length() const;
+
+    private:
+        size_t mAlign;
+        endian::Type mEndian;
+        const std::byte *mNote;
+        const std::byte *mEnd;
+    };
+
+    class NoteTable {
+    public:
+        NoteTable(Reader reader, std::shared_ptr<ISection> section);
+        NoteTable(Reader reader, std::shared_ptr<ISegment> segment);
+
+    public:
+        NoteIterator begin();
+        NoteIterator end();
+
+    private:
+        Reader mReader;
+        size_t mAlign;
+        Elf64_Xword mSize;
+        const std::byte *mData;
+    };
+
+    std::optional<std::vector<std::byte>> buildID(const Reader &reader);
+}
+
+#endif //ELF_NOTE_H
@@ -0,0 +1,11 @@
+#ifndef ELF_PLT_H
+#define ELF_PLT_H
+
+#include "address.h"
+
+namespace elf {
+    // synthetic name@plt ranges for the stubs in .plt, .plt.sec and .plt.got, x86-64 and AArch64 only
+    std::vector<AddressRange> pltRanges(const Reader &reader);
+}
+
+#endif //ELF_PLT_H
@@ -0,0 +1,63 @@
+#ifndef ELF_POOL_H
+#define ELF_POOL_H
+
+#include "reader.h"
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <condition_variable>
+#include <sys/stat.h>
+
+namespace elf {
+    // Readers handed out by the pool lease their mapping until the last copy is destroyed, and may outlive the pool.
+    // Idle mappings are unmapped in LRU order once a limit is reached, and remapped on the next open.
+    // When every mapping is leased, open maps past the limits and the surplus is unmapped as leases are released.
+    // Files replaced on disk are noticed by inode, size and mtime, readers already handed out keep the old mapping.
+    class ReaderPool {
+    private:
+        struct Entry {
+            std::string path;
+            dev_t device;
+            ino_t inode;
+            size_t size;
+            timespec modified;
+            size_t leases;
+            bool stale;
+            std::shared_ptr<void> buffer;
+        };
+
+        struct State {
+            size_t maxMappings;
+            size_t maxBytes;
+            size_t mappings;
+            size_t bytes;
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::list<Entry> entries;
+            std::unordered_map<std::string, std::list<Entry>::iterator> index;
+        };
+
+    public:
+        ReaderPool(size_t maxMappings, size_t maxBytes);
+
+    public:
+        tl::expected<Reader, std::error_code> open(const std::filesystem::path &path);
+
+    public:
+        size_t mappings();
+        size_t bytes();
+        void clear();
+
+    private:
+        static Reader lease(const std::shared_ptr<State> &state, std::list<Entry>::iterator it);
+        static void release(State &state, std::list<Entry>::iterator it);
+        static void retire(State &state, std::list<Entry>::iterator it);
+        static void erase(State &state, std::list<Entry>::iterator it);
+        static bool evict(State &state);
+
+    private:
+        std::shared_ptr<State> mState;
+    };
+}
+
+#endif //ELF_POOL_H
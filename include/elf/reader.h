@@ -9,27 +9,55 @@
 #include <vector>
 #include <optional>
 #include <filesystem>
+#include <map>
+#include <mutex>
 #include <tl/expected.hpp>
 
 namespace elf {
+    // copies share one context, safe for concurrent readers. tables are built on first use and never change afterwards,
+    // and the handles in them are read-only.
     class Reader {
+    private:
+        struct Context {
+            std::shared_ptr<IHeader> header;
+            std::once_flag segmentsOnce;
+            std::vector<std::shared_ptr<ISegment>> segments;
+            std::once_flag sectionsOnce;
+            std::vector<std::shared_ptr<ISection>> sections;
+            std::once_flag namesOnce;
+            std::map<std::string, size_t, std::less<>> names;
+        };
+
+    public:
+        // length is 0 when the caller does not know how many bytes the buffer holds
+        explicit Reader(std::shared_ptr<void> buffer, size_t length = 0);
+
     public:
-        explicit Reader(std::shared_ptr<void> buffer);
+        [[nodiscard]] const std::shared_ptr<void> &buffer() const;
+        [[nodiscard]] size_t length() const;
 
     public:
-        [[nodiscard]] std::unique_ptr<IHeader> header() const;
-        [[nodiscard]] std::vector<std::shared_ptr<ISegment>> segments() const;
-        [[nodiscard]] std::vector<std::shared_ptr<ISection>> sections() const;
+        [[nodiscard]] const std::shared_ptr<IHeader> &header() const;
+        [[nodiscard]] const std::vector<std::shared_ptr<ISegment>> &segments() const;
+        [[nodiscard]] const std::vector<std::shared_ptr<ISection>> &sections() const;
+        [[nodiscard]] std::shared_ptr<ISection> section(size_t index) const;
+        [[nodiscard]] std::shared_ptr<ISection> section(std::string_view name) const;
 
     public:
         [[nodiscard]] const std::byte *virtualMemory(Elf64_Addr address) const;
         [[nodiscard]] std::optional<std::vector<std::byte>> readVirtualMemory(Elf64_Addr address, Elf64_Xword length) const;
 
+    private:
+        [[nodiscard]] std::shared_ptr<ISection> sectionAt(IHeader &header, size_t index, const char *strings) const;
+
     private:
         std::shared_ptr<void> mBuffer;
+        size_t mLength;
+        std::shared_ptr<Context> mContext;
     };
 
     tl::expected<Reader, std::error_code> openFile(const std::filesystem::path &path);
+    tl::expected<Reader, std::error_code> openMemory(std::shared_ptr<void> buffer, size_t length);
 }
 
 #endif //ELF_READER_H
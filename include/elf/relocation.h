@@ -37,13 +37,14 @@ namespace elf {
         Elf64_Xword symbolIndex() override;
 
     private:
-        const T *mRelocation;
+        T mRelocation;
         std::shared_ptr<ISymbol> mSymbol;
     };
 
+    // resolves symbols through the owning table, valid while that table object is alive
     class RelocationIterator {
     public:
-        RelocationIterator(const std::byte *relocation, size_t size, endian::Type endian, bool addend, SymbolTable symbolTable);
+        RelocationIterator(const std::byte *relocation, size_t size, endian::Type endian, bool addend, SymbolTable *symbolTable);
 
     public:
         std::unique_ptr<IRelocation> operator*();
@@ -55,11 +56,74 @@ namespace elf {
         bool operator!=(const RelocationIterator &rhs);
 
     private:
-        bool mAddend;
+        const std::byte *mRelocation;
         size_t mSize;
         endian::Type mEndian;
-        SymbolTable mSymbolTable;
+        bool mAddend;
+        SymbolTable *mSymbolTable;
+    };
+
+    struct RelocationView {
+        Elf64_Addr offset;
+        Elf64_Xword info;
+        Elf64_Sxword addend;
+        Elf64_Xword type;
+        Elf64_Xword symbolIndex;
+        std::optional<SymbolView> symbol;
+    };
+
+    // decodes entries by value, nothing is allocated while iterating. valid while the table's Reader is alive.
+    class RelocationViewIterator {
+    public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = RelocationView;
+        using pointer = value_type *;
+        using reference = value_type;
+        using iterator_category = std::random_access_iterator_tag;
+
+    public:
+        RelocationViewIterator(
+                const std::byte *relocation,
+                size_t size,
+                endian::Type endian,
+                bool addend,
+                SymbolViews symbols
+        );
+
+    public:
+        RelocationView operator*() const;
+        RelocationViewIterator &operator--();
+        RelocationViewIterator &operator++();
+        RelocationViewIterator &operator+=(std::ptrdiff_t offset);
+        RelocationViewIterator operator-(std::ptrdiff_t offset) const;
+        RelocationViewIterator operator+(std::ptrdiff_t offset) const;
+
+    public:
+        bool operator==(const RelocationViewIterator &rhs) const;
+        bool operator!=(const RelocationViewIterator &rhs) const;
+
+    public:
+        std::ptrdiff_t operator-(const RelocationViewIterator &rhs) const;
+
+    private:
         const std::byte *mRelocation;
+        size_t mSize;
+        endian::Type mEndian;
+        bool mAddend;
+        SymbolViews mSymbols;
+    };
+
+    class RelocationViews {
+    public:
+        RelocationViews(RelocationViewIterator begin, RelocationViewIterator end);
+
+    public:
+        [[nodiscard]] RelocationViewIterator begin() const;
+        [[nodiscard]] RelocationViewIterator end() const;
+
+    private:
+        RelocationViewIterator mBegin;
+        RelocationViewIterator mEnd;
     };
 
     class RelocationTable {
@@ -76,9 +140,41 @@ namespace elf {
         RelocationIterator begin();
         RelocationIterator end();
 
+    public:
+        RelocationView view(size_t index);
+        RelocationViews views();
+
     private:
         Reader mReader;
         std::shared_ptr<ISection> mSection;
+        SymbolTable mSymbolTable;
+    };
+
+    struct RelocationEntry {
+        RelocationView relocation;
+        Elf64_Word sectionType;
+        size_t section;
+    };
+
+    // load time relocations of every allocated REL, RELA and RELR section, sorted by the slot they patch
+    class RelocationIndex {
+    public:
+        explicit RelocationIndex(Reader reader);
+
+    public:
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] const std::vector<RelocationEntry> &entries() const;
+
+    public:
+        [[nodiscard]] const RelocationEntry *find(Elf64_Addr offset) const;
+        [[nodiscard]] std::pair<const RelocationEntry *, const RelocationEntry *> range(Elf64_Addr begin, Elf64_Addr end) const;
+
+    public:
+        [[nodiscard]] std::optional<Elf64_Addr> read(Elf64_Addr address, Elf64_Addr base) const;
+
+    private:
+        Reader mReader;
+        std::vector<RelocationEntry> mEntries;
     };
 }
 
@@ -0,0 +1,43 @@
+#ifndef ELF_SCANNER_H
+#define ELF_SCANNER_H
+
+#include "reader.h"
+#include <thread>
+#include <unordered_map>
+
+namespace elf {
+    struct Library {
+        std::filesystem::path path;
+        std::string soname;
+        std::vector<std::string> needed;
+        std::vector<std::string> symbols;
+    };
+
+    class SymbolIndex {
+    public:
+        [[nodiscard]] const std::vector<Library> &libraries() const;
+        [[nodiscard]] std::vector<const Library *> find(const std::string &symbol) const;
+
+    public:
+        void insert(Library library);
+
+    private:
+        std::vector<Library> mLibraries;
+        std::unordered_map<std::string, std::vector<size_t>> mSymbols;
+    };
+
+    class Scanner {
+    public:
+        explicit Scanner(size_t concurrency = std::thread::hardware_concurrency());
+
+    public:
+        SymbolIndex scan(const std::vector<std::filesystem::path> &roots);
+
+    private:
+        size_t mConcurrency;
+    };
+
+    std::optional<Library> inspect(const std::filesystem::path &path);
+}
+
+#endif //ELF_SCANNER_H
@@ -0,0 +1,30 @@
+#ifndef ELF_SEARCH_H
+#define ELF_SEARCH_H
+
+#include "symbol.h"
+#include <regex>
+
+namespace elf {
+    // scans the raw string table for a literal, then maps hits back to symbols through an offset index built once
+    class SymbolSearch {
+    public:
+        explicit SymbolSearch(SymbolTable table);
+
+    public:
+        std::vector<size_t> contains(std::string_view literal);
+        std::vector<size_t> prefix(std::string_view literal);
+        std::vector<size_t> glob(std::string_view pattern);
+        std::vector<size_t> match(const std::regex &regex, std::string_view literal = {});
+
+    private:
+        template<typename F>
+        std::vector<size_t> scan(std::string_view literal, F &&f);
+
+    private:
+        SymbolTable mTable;
+        std::string_view mStrings;
+        std::vector<std::pair<Elf64_Word, size_t>> mIndex;
+    };
+}
+
+#endif //ELF_SEARCH_H
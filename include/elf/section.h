@@ -7,13 +7,13 @@
 #include <memory>
 
 namespace elf {
+    // handles point into the mapping without owning it, keep a Reader over the file alive while using one
     class ISection {
     public:
         virtual ~ISection() = default;
 
     public:
         virtual std::string name() = 0;
-        virtual void name(std::string_view name) = 0;
         virtual const std::byte *data() = 0;
 
     public:
@@ -29,14 +29,14 @@ namespace elf {
         virtual Elf64_Xword entrySize() = 0;
     };
 
+    // borrows the mapping, valid while a Reader over it is alive
     template<typename T, endian::Type Endian>
     class Section : public ISection {
     public:
-        Section(const T *section, std::shared_ptr<void> buffer);
+        Section(const T *section, const std::byte *buffer, const char *strings = nullptr);
 
     public:
         std::string name() override;
-        void name(std::string_view name) override;
         const std::byte *data() override;
 
     public:
@@ -52,9 +52,9 @@ namespace elf {
         Elf64_Xword entrySize() override;
 
     private:
-        const T *mSection;
+        T mSection;
         std::string mName;
-        std::shared_ptr<void> mBuffer;
+        const std::byte *mBuffer;
     };
 }
 
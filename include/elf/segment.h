@@ -7,6 +7,7 @@
 #include <memory>
 
 namespace elf {
+    // handles point into the mapping without owning it, keep a Reader over the file alive while using one
     class ISegment {
     public:
         virtual ~ISegment() = default;
@@ -25,10 +26,11 @@ namespace elf {
         virtual Elf64_Xword align() = 0;
     };
 
+    // borrows the mapping, valid while a Reader over it is alive
     template<typename T, endian::Type Endian>
     class Segment : public ISegment {
     public:
-        Segment(const T *segment, std::shared_ptr<void> buffer);
+        Segment(const T *segment, const std::byte *buffer);
 
     public:
         const std::byte *data() override;
@@ -44,8 +46,8 @@ namespace elf {
         Elf64_Xword align() override;
 
     private:
-        const T *mSegment;
-        std::shared_ptr<void> mBuffer;
+        T mSegment;
+        const std::byte *mBuffer;
     };
 }
 
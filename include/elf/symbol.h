@@ -10,13 +10,12 @@ namespace elf {
 
     public:
         virtual std::string name() = 0;
-        virtual void name(std::string_view name) = 0;
 
     public:
         virtual Elf64_Word nameIndex() = 0;
         virtual unsigned char info() = 0;
         virtual unsigned char other() = 0;
-        virtual Elf64_Section sectionIndex() = 0;
+        virtual Elf64_Word sectionIndex() = 0;
         virtual Elf64_Addr value() = 0;
         virtual Elf64_Xword size() = 0;
     };
@@ -24,25 +23,26 @@ namespace elf {
     template<typename T, endian::Type Endian>
     class Symbol : public ISymbol {
     public:
-        explicit Symbol(const T *symbol);
+        explicit Symbol(const T *symbol, const Elf32_Word *extended = nullptr, const char *strings = nullptr);
 
     public:
         std::string name() override;
-        void name(std::string_view name) override;
 
     public:
         Elf64_Word nameIndex() override;
         unsigned char info() override;
         unsigned char other() override;
-        Elf64_Section sectionIndex() override;
+        Elf64_Word sectionIndex() override;
         Elf64_Addr value() override;
         Elf64_Xword size() override;
 
     private:
-        const T *mSymbol;
+        T mSymbol;
+        const Elf32_Word *mExtended;
         std::string mName;
     };
 
+    // points into the mapping, valid while the table's Reader is alive
     class SymbolIterator {
     public:
         using difference_type = std::ptrdiff_t;
@@ -52,7 +52,13 @@ namespace elf {
         using iterator_category = std::random_access_iterator_tag;
 
     public:
-        SymbolIterator(const std::byte *symbol, size_t size, endian::Type endian, std::shared_ptr<ISection> section);
+        SymbolIterator(
+                const std::byte *symbol,
+                const std::byte *extended,
+                size_t size,
+                endian::Type endian,
+                const char *strings
+        );
 
     public:
         std::unique_ptr<ISymbol> operator*();
@@ -70,10 +76,77 @@ namespace elf {
         std::ptrdiff_t operator-(const SymbolIterator &rhs);
 
     private:
+        const std::byte *mSymbol;
+        const std::byte *mExtended;
         size_t mSize;
         endian::Type mEndian;
+        const char *mStrings;
+    };
+
+    struct SymbolView {
+        std::string_view name;
+        Elf64_Word nameIndex;
+        unsigned char info;
+        unsigned char other;
+        Elf64_Word sectionIndex;
+        Elf64_Addr value;
+        Elf64_Xword size;
+    };
+
+    // decodes entries by value, nothing is allocated while iterating. names point into the mapping like the iterator.
+    class SymbolViewIterator {
+    public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = SymbolView;
+        using pointer = value_type *;
+        using reference = value_type;
+        using iterator_category = std::random_access_iterator_tag;
+
+    public:
+        SymbolViewIterator(
+                const std::byte *symbol,
+                const std::byte *extended,
+                size_t size,
+                endian::Type endian,
+                const char *strings,
+                Elf64_Xword length
+        );
+
+    public:
+        SymbolView operator*() const;
+        SymbolViewIterator &operator--();
+        SymbolViewIterator &operator++();
+        SymbolViewIterator &operator+=(std::ptrdiff_t offset);
+        SymbolViewIterator operator-(std::ptrdiff_t offset) const;
+        SymbolViewIterator operator+(std::ptrdiff_t offset) const;
+
+    public:
+        bool operator==(const SymbolViewIterator &rhs) const;
+        bool operator!=(const SymbolViewIterator &rhs) const;
+
+    public:
+        std::ptrdiff_t operator-(const SymbolViewIterator &rhs) const;
+
+    private:
         const std::byte *mSymbol;
-        std::shared_ptr<ISection> mSection;
+        const std::byte *mExtended;
+        size_t mSize;
+        endian::Type mEndian;
+        const char *mStrings;
+        Elf64_Xword mLength;
+    };
+
+    class SymbolViews {
+    public:
+        SymbolViews(SymbolViewIterator begin, SymbolViewIterator end);
+
+    public:
+        [[nodiscard]] SymbolViewIterator begin() const;
+        [[nodiscard]] SymbolViewIterator end() const;
+
+    private:
+        SymbolViewIterator mBegin;
+        SymbolViewIterator mEnd;
     };
 
     class SymbolTable {
@@ -82,6 +155,7 @@ namespace elf {
 
     public:
         size_t size();
+        std::shared_ptr<ISection> strings();
 
     public:
         std::unique_ptr<ISymbol> operator[](size_t index);
@@ -90,9 +164,16 @@ namespace elf {
         SymbolIterator begin();
         SymbolIterator end();
 
+    public:
+        SymbolView view(size_t index);
+        SymbolViews views();
+
     private:
         Reader mReader;
+        endian::Type mEndian;
         std::shared_ptr<ISection> mSection;
+        std::shared_ptr<ISection> mStrings;
+        std::shared_ptr<ISection> mIndices;
     };
 }
 
@@ -0,0 +1,104 @@
+#ifndef ELF_UNWIND_H
+#define ELF_UNWIND_H
+
+#include "reader.h"
+#include <array>
+#include <bitset>
+#include <functional>
+#include <shared_mutex>
+
+namespace elf {
+    // enough DWARF register numbers for x86-64 (0-16) and AArch64 (0-32)
+    constexpr size_t MAX_REGISTERS = 33;
+
+    enum class RuleType {
+        UNDEFINED,
+        SAME_VALUE,
+        OFFSET,
+        VAL_OFFSET,
+        REGISTER,
+        EXPRESSION,
+        VAL_EXPRESSION
+    };
+
+    struct Rule {
+        RuleType type = RuleType::UNDEFINED;
+        Elf64_Word reg = 0;
+        Elf64_Sxword offset = 0;
+        const std::byte *expression = nullptr;
+        Elf64_Xword length = 0;
+    };
+
+    struct UnwindRow {
+        Elf64_Addr begin;
+        Elf64_Addr end;
+        Elf64_Word returnAddress;
+        bool signal;
+        // AArch64 return address signed with pointer authentication, step strips it before use
+        bool signedReturnAddress;
+        Rule cfa;
+        std::array<Rule, MAX_REGISTERS> registers;
+    };
+
+    struct FDE {
+        Elf64_Addr begin;
+        Elf64_Addr end;
+        Elf64_Addr address;
+    };
+
+    struct Registers {
+        std::array<Elf64_Addr, MAX_REGISTERS> values;
+        std::bitset<MAX_REGISTERS> valid;
+        bool caller;
+    };
+
+    using MemoryReader = std::function<std::optional<Elf64_Addr>(Elf64_Addr address)>;
+
+    class EHFrame {
+    private:
+        struct Evaluated {
+            Elf64_Addr begin;
+            Elf64_Addr end;
+            std::vector<UnwindRow> rows;
+        };
+
+    public:
+        explicit EHFrame(Reader reader);
+
+    public:
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] std::optional<FDE> find(Elf64_Addr address) const;
+
+    public:
+        const UnwindRow *row(Elf64_Addr address);
+        bool step(Registers &registers, Elf64_Addr bias, const MemoryReader &read);
+
+    private:
+        [[nodiscard]] std::optional<FDE> entry(Elf64_Addr address) const;
+        [[nodiscard]] std::vector<UnwindRow> evaluate(const FDE &fde) const;
+
+    private:
+        Reader mReader;
+        Elf64_Half mMachine;
+        endian::Type mEndian;
+        size_t mAddressSize;
+
+    private:
+        const std::byte *mFrame;
+        Elf64_Addr mFrameAddress;
+        Elf64_Xword mFrameSize;
+
+    private:
+        const std::byte *mTable;
+        Elf64_Addr mTableAddress;
+        Elf64_Xword mTableCount;
+        std::vector<std::pair<Elf64_Addr, Elf64_Addr>> mEntries;
+
+    private:
+        std::shared_mutex mMutex;
+        // evaluated entries sorted by start, a hit never touches .eh_frame_hdr
+        std::vector<Evaluated> mRows;
+    };
+}
+
+#endif //ELF_UNWIND_H
@@ -0,0 +1,65 @@
+#ifndef ELF_WATCH_H
+#define ELF_WATCH_H
+
+#include "reader.h"
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <sys/stat.h>
+
+namespace elf {
+    // the current reader of a watched file, readers keep the mapping they loaded alive until they drop it
+    class WatchedReader {
+    public:
+        explicit WatchedReader(Reader reader);
+
+    public:
+        [[nodiscard]] Reader reader() const;
+        [[nodiscard]] size_t generation() const;
+
+    private:
+        friend class ReaderWatcher;
+
+        std::shared_ptr<const Reader> mReader;
+        std::atomic<size_t> mGeneration;
+
+        // only touched by the watcher thread once published
+        std::optional<std::vector<std::byte>> mID;
+        std::pair<dev_t, ino_t> mInode;
+        off_t mSize;
+        timespec mModified;
+    };
+
+    // follows replaced or rewritten files through their directory, a file whose build id is unchanged keeps its reader
+    class ReaderWatcher {
+    private:
+        // one watch per inode, a directory reached through several paths (such as /lib and /usr/lib on a merged /usr)
+        // counts the watched files under each spelling
+        struct Directory {
+            std::unordered_map<std::string, size_t> paths;
+        };
+
+    public:
+        ReaderWatcher();
+        ~ReaderWatcher();
+
+    public:
+        tl::expected<std::shared_ptr<WatchedReader>, std::error_code> open(const std::filesystem::path &path);
+        void unwatch(const std::filesystem::path &path);
+
+    private:
+        std::error_code start();
+        void run();
+        void refresh(const std::filesystem::path &path);
+
+    private:
+        int mFD;
+        int mEvent;
+        std::thread mThread;
+        std::mutex mMutex;
+        std::unordered_map<int, Directory> mDirectories;
+        std::unordered_map<std::string, std::pair<int, std::shared_ptr<WatchedReader>>> mFiles;
+    };
+}
+
+#endif //ELF_WATCH_H
@@ -0,0 +1,79 @@
+#ifndef ELF_WRITER_H
+#define ELF_WRITER_H
+
+#include "reader.h"
+#include <map>
+
+namespace elf {
+    // collects edits against the original file and writes only the ranges they touch.
+    // allocated sections keep their place and size, everything else may move to the end of the file.
+    // the reader sees a half applied file once it is updated in place, so a writer is used once.
+    class Writer {
+    private:
+        struct Addition {
+            std::string name;
+            Elf64_Word type;
+            Elf64_Xword flags;
+            Elf64_Xword addressAlign;
+            std::vector<std::byte> data;
+        };
+
+        struct Plan {
+            std::vector<std::pair<Elf64_Off, std::vector<std::byte>>> writes;
+            Elf64_Off size;
+        };
+
+    public:
+        Writer(Reader reader, std::filesystem::path path);
+
+    public:
+        [[nodiscard]] const Reader &reader() const;
+
+    public:
+        std::error_code replace(size_t index, std::vector<std::byte> data);
+        std::error_code replace(std::string_view name, std::vector<std::byte> data);
+
+    public:
+        std::error_code addSection(
+                std::string name,
+                Elf64_Word type,
+                std::vector<std::byte> data,
+                Elf64_Xword addressAlign = 1,
+                Elf64_Xword flags = 0
+        );
+
+        std::error_code addNote(
+                std::string section,
+                std::string_view owner,
+                Elf64_Word type,
+                const std::vector<std::byte> &descriptor
+        );
+
+    public:
+        std::error_code dynamic(Elf64_Sxword tag, Elf64_Xword value);
+        void entry(Elf64_Addr address);
+
+    public:
+        std::error_code write(const std::filesystem::path &path) const;
+        std::error_code update() const;
+
+    private:
+        [[nodiscard]] tl::expected<Plan, std::error_code> plan() const;
+
+        template<typename Ehdr, typename Shdr, endian::Type Endian>
+        tl::expected<Plan, std::error_code> plan(Elf64_Off length) const;
+
+    private:
+        Reader mReader;
+        std::filesystem::path mPath;
+        std::map<size_t, std::vector<std::byte>> mReplacements;
+        std::vector<Addition> mAdditions;
+        std::vector<std::pair<Elf64_Off, std::vector<std::byte>>> mPatches;
+        std::map<size_t, Elf64_Sxword> mDynamicTags;
+        std::optional<Elf64_Addr> mEntry;
+    };
+
+    tl::expected<Writer, std::error_code> openWriter(const std::filesystem::path &path);
+}
+
+#endif //ELF_WRITER_H
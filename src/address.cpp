@@ -0,0 +1,116 @@
+#include <elf/address.h>
+#include <elf/demangle.h>
+#include <algorithm>
+#include <limits>
+
+// sizeless entries only match their own address
+static Elf64_Addr end(const elf::AddressRange &range) {
+    Elf64_Xword size = std::max<Elf64_Xword>(range.size, 1);
+
+    if (range.address > std::numeric_limits<Elf64_Addr>::max() - size)
+        return std::numeric_limits<Elf64_Addr>::max();
+
+    return range.address + size;
+}
+
+elf::AddressMap::AddressMap(std::vector<AddressRange> ranges) {
+    insert(std::move(ranges));
+}
+
+size_t elf::AddressMap::size() const {
+    return mRanges.size();
+}
+
+const std::vector<elf::AddressRange> &elf::AddressMap::ranges() const {
+    return mRanges;
+}
+
+const elf::AddressRange *elf::AddressMap::find(Elf64_Addr address) const {
+    auto it = std::upper_bound(
+            mRanges.begin(),
+            mRanges.end(),
+            address,
+            [](Elf64_Addr address, const auto &range) {
+                return address < range.address;
+            }
+    );
+
+    // the nearest start may be a short range nested before the address inside a longer one
+    for (auto index = (size_t) (it - mRanges.begin()); index > 0 && mReach[index - 1] > address; index--) {
+        if (address < end(mRanges[index - 1]))
+            return &mRanges[index - 1];
+    }
+
+    return nullptr;
+}
+
+void elf::AddressMap::insert(std::vector<AddressRange> ranges) {
+    size_t middle = mRanges.size();
+
+    mRanges.insert(
+            mRanges.end(),
+            std::make_move_iterator(ranges.begin()),
+            std::make_move_iterator(ranges.end())
+    );
+
+    auto compare = [](const auto &lhs, const auto &rhs) {
+        if (lhs.address != rhs.address)
+            return lhs.address < rhs.address;
+
+        return lhs.size > rhs.size;
+    };
+
+    std::sort(mRanges.begin() + (std::ptrdiff_t) middle, mRanges.end(), compare);
+    std::inplace_merge(mRanges.begin(), mRanges.begin() + (std::ptrdiff_t) middle, mRanges.end(), compare);
+
+    // aliases share an address, keep the widest
+    mRanges.erase(
+            std::unique(
+                    mRanges.begin(),
+                    mRanges.end(),
+                    [](const auto &lhs, const auto &rhs) {
+                        return lhs.address == rhs.address;
+                    }
+            ),
+            mRanges.end()
+    );
+
+    mReach.resize(mRanges.size());
+
+    for (size_t i = 0; i < mRanges.size(); i++)
+        mReach[i] = std::max(i ? mReach[i - 1] : 0, end(mRanges[i]));
+}
+
+std::vector<elf::AddressRange> elf::symbolRanges(const Reader &reader, bool demangle) {
+    auto section = reader.section(".symtab");
+
+    if (!section || section->type() != SHT_SYMTAB)
+        section = reader.section(".dynsym");
+
+    if (!section || section->type() == SHT_NOBITS)
+        return {};
+
+    SymbolTable table(reader, section);
+    std::optional<Demangler> demangler;
+
+    if (demangle) {
+        demangler.emplace(table);
+        demangler->demangle();
+    }
+
+    std::vector<AddressRange> ranges;
+
+    for (const auto &symbol: table.views()) {
+        unsigned char type = ELF64_ST_TYPE(symbol.info);
+
+        if (type != STT_FUNC && type != STT_GNU_IFUNC && type != STT_OBJECT)
+            continue;
+
+        if (symbol.sectionIndex == SHN_UNDEF || symbol.name.empty())
+            continue;
+
+        ranges.push_back({symbol.value, symbol.size, std::string(demangler ? demangler->name(symbol) : symbol.name)});
+    }
+
+    return ranges;
+}
@@ -0,0 +1,294 @@
+#include <elf/archive.h>
+#include <elf/symbol.h>
+#include <elf/error.h>
+#include "cursor.h"
+#include "mapping.h"
+#include <ar.h>
+#include <atomic>
+#include <limits>
+#include <unordered_map>
+
+static std::string_view field(const char *data, size_t size) {
+    std::string_view value(data, size);
+    return value.substr(0, value.find_last_not_of(' ') + 1);
+}
+
+static std::optional<Elf64_Xword> number(std::string_view value) {
+    if (value.empty())
+        return std::nullopt;
+
+    Elf64_Xword result = 0;
+
+    for (const auto &c: value) {
+        if (c < '0' || c > '9' || result > (std::numeric_limits<Elf64_Xword>::max() - 9) / 10)
+            return std::nullopt;
+
+        result = result * 10 + (c - '0');
+    }
+
+    return result;
+}
+
+// gnu tables hold big-endian header offsets followed by their names, bsd tables (name, offset) pairs
+static std::optional<std::vector<std::pair<std::string_view, Elf64_Off>>>
+symbolTable(std::string_view name, std::string_view data) {
+    bool gnu = name == "/" || name == "/SYM64/";
+    bool wide = name == "/SYM64/" || name.find("_64") != std::string_view::npos;
+
+    auto word = [=](elf::Cursor &cursor) -> Elf64_Xword {
+        return wide ? cursor.read<Elf64_Xword>() : cursor.read<Elf32_Word>();
+    };
+
+    std::vector<std::pair<std::string_view, Elf64_Off>> symbols;
+    elf::Cursor cursor((const std::byte *) data.data(), data.size(), gnu ? elf::endian::Big : elf::endian::Little);
+
+    if (gnu) {
+        Elf64_Xword count = word(cursor);
+
+        if (cursor.failed() || count > cursor.remaining() / (wide ? 8 : 4))
+            return std::nullopt;
+
+        elf::Cursor offsets(cursor.skip(count * (wide ? 8 : 4)), count * (wide ? 8 : 4), elf::endian::Big);
+
+        for (Elf64_Xword i = 0; i < count; i++) {
+            Elf64_Off offset = word(offsets);
+            auto symbol = cursor.string();
+
+            if (cursor.failed())
+                return std::nullopt;
+
+            symbols.emplace_back(symbol, offset);
+        }
+
+        return symbols;
+    }
+
+    Elf64_Xword size = word(cursor);
+
+    if (cursor.failed() || size > cursor.remaining())
+        return std::nullopt;
+
+    elf::Cursor entries(cursor.skip(size), size, elf::endian::Little);
+
+    Elf64_Xword length = word(cursor);
+    auto strings = (const char *) cursor.current();
+
+    if (cursor.failed() || length > cursor.remaining())
+        return std::nullopt;
+
+    while (entries.remaining() >= (wide ? 16 : 8)) {
+        Elf64_Xword index = word(entries);
+        Elf64_Off offset = word(entries);
+
+        if (index >= length)
+            return std::nullopt;
+
+        symbols.emplace_back(std::string_view(strings + index, strnlen(strings + index, length - index)), offset);
+    }
+
+    return symbols;
+}
+
+elf::Archive::Archive(
+        std::shared_ptr<void> buffer,
+        std::vector<ArchiveMember> members,
+        std::map<std::string, size_t, std::less<>> symbols
+) : mBuffer(std::move(buffer)), mMembers(std::move(members)), mSymbols(std::move(symbols)) {
+
+}
+
+const std::vector<elf::ArchiveMember> &elf::Archive::members() const {
+    return mMembers;
+}
+
+const std::map<std::string, size_t, std::less<>> &elf::Archive::symbols() const {
+    return mSymbols;
+}
+
+std::optional<size_t> elf::Archive::find(std::string_view symbol) const {
+    auto it = mSymbols.find(symbol);
+
+    if (it == mSymbols.end())
+        return std::nullopt;
+
+    return it->second;
+}
+
+tl::expected<elf::Reader, std::error_code> elf::Archive::reader(size_t index) const {
+    if (index >= mMembers.size())
+        return tl::unexpected(std::make_error_code(std::errc::invalid_argument));
+
+    const auto &member = mMembers[index];
+    auto data = (const std::byte *) mBuffer.get() + member.offset;
+
+    // aliases the archive mapping, the member shares its lifetime. ar only pads members to even offsets,
+    // which is fine since headers are copied out rather than read in place.
+    return openMemory(std::shared_ptr<void>(mBuffer, (void *) data), member.size);
+}
+
+std::vector<tl::expected<elf::Reader, std::error_code>> elf::Archive::index(size_t concurrency) {
+    std::vector<tl::expected<Reader, std::error_code>> readers(
+            mMembers.size(),
+            tl::unexpected(std::error_code())
+    );
+
+    std::atomic<size_t> next = 0;
+    std::vector<std::vector<std::pair<std::string, size_t>>> results(
+            std::min(std::max<size_t>(concurrency, 1), std::max<size_t>(mMembers.size(), 1))
+    );
+    std::vector<std::thread> threads;
+
+    for (auto &result: results) {
+        threads.emplace_back([&]() {
+            while (true) {
+                size_t index = next++;
+
+                if (index >= mMembers.size())
+                    break;
+
+                auto reader = this->reader(index);
+
+                if (reader) {
+                    auto header = reader->header();
+                    Elf64_Xword size = mMembers[index].size;
+
+                    // skip members whose section header table lies outside them
+                    if (header->sectionOffset() + header->sectionEntrySize() > size ||
+                        header->sectionOffset() + (Elf64_Xword) header->sectionNum() * header->sectionEntrySize() > size) {
+                        readers[index] = tl::unexpected(make_error_code(Error::INVALID_ELF_HEADER));
+                        continue;
+                    }
+
+                    auto symtab = reader->section(".symtab");
+
+                    if (symtab && symtab->type() == SHT_SYMTAB) {
+                        for (const auto &symbol: SymbolTable(*reader, symtab).views()) {
+                            unsigned char bind = ELF64_ST_BIND(symbol.info);
+
+                            if (symbol.sectionIndex == SHN_UNDEF || symbol.name.empty())
+                                continue;
+
+                            if (bind != STB_GLOBAL && bind != STB_WEAK && bind != STB_GNU_UNIQUE)
+                                continue;
+
+                            result.emplace_back(symbol.name, index);
+                        }
+                    }
+                }
+
+                readers[index] = std::move(reader);
+            }
+        });
+    }
+
+    for (auto &thread: threads)
+        thread.join();
+
+    for (auto &result: results) {
+        for (auto &[symbol, index]: result)
+            mSymbols.emplace(std::move(symbol), index);
+    }
+
+    return readers;
+}
+
+tl::expected<elf::Archive, std::error_code> elf::openArchive(const std::filesystem::path &path) {
+    auto mapping = mapFile(path);
+
+    if (!mapping)
+        return tl::unexpected(mapping.error());
+
+    return openArchive(std::move(mapping->buffer), mapping->length);
+}
+
+tl::expected<elf::Archive, std::error_code> elf::openArchive(std::shared_ptr<void> buffer, size_t length) {
+    auto data = (const char *) buffer.get();
+
+    if (length < SARMAG || memcmp(data, ARMAG, SARMAG) != 0)
+        return tl::unexpected(Error::INVALID_ARCHIVE_MAGIC);
+
+    std::vector<ArchiveMember> members;
+    std::string_view names;
+    std::vector<std::pair<std::string_view, std::string_view>> tables;
+
+    for (Elf64_Off offset = SARMAG; offset < length;) {
+        if (length - offset < sizeof(ar_hdr))
+            return tl::unexpected(Error::INVALID_ARCHIVE_HEADER);
+
+        auto header = (const ar_hdr *) (data + offset);
+        auto size = number(field(header->ar_size, sizeof(header->ar_size)));
+
+        if (memcmp(header->ar_fmag, ARFMAG, sizeof(header->ar_fmag)) != 0 ||
+            !size || *size > length - offset - sizeof(ar_hdr))
+            return tl::unexpected(Error::INVALID_ARCHIVE_HEADER);
+
+        ArchiveMember member = {{}, offset, offset + sizeof(ar_hdr), *size};
+        auto name = field(header->ar_name, sizeof(header->ar_name));
+
+        offset = member.offset + *size + (*size & 1);
+
+        if (name == "/" || name == "/SYM64/") {
+            tables.emplace_back(name, std::string_view(data + member.offset, member.size));
+            continue;
+        }
+
+        if (name == "//") {
+            names = {data + member.offset, member.size};
+            continue;
+        }
+
+        if (name.substr(0, 3) == "#1/") {
+            // bsd keeps long names in front of the member data
+            auto bytes = number(name.substr(3));
+
+            if (!bytes || *bytes > member.size)
+                return tl::unexpected(Error::INVALID_ARCHIVE_HEADER);
+
+            name = {data + member.offset, strnlen(data + member.offset, *bytes)};
+            member.offset += *bytes;
+            member.size -= *bytes;
+        } else if (name.size() > 1 && name[0] == '/') {
+            auto index = number(name.substr(1));
+
+            if (!index || *index >= names.size())
+                return tl::unexpected(Error::INVALID_ARCHIVE_HEADER);
+
+            name = names.substr(*index);
+            name = name.substr(0, name.find('\n'));
+        }
+
+        if (name.substr(0, 9) == "__.SYMDEF") {
+            tables.emplace_back(name, std::string_view(data + member.offset, member.size));
+            continue;
+        }
+
+        if (!name.empty() && name.back() == '/')
+            name.remove_suffix(1);
+
+        member.name = name;
+        members.push_back(std::move(member));
+    }
+
+    std::unordered_map<Elf64_Off, size_t> headers;
+
+    for (size_t i = 0; i < members.size(); i++)
+        headers.emplace(members[i].header, i);
+
+    std::map<std::string, size_t, std::less<>> symbols;
+
+    for (const auto &[name, table]: tables) {
+        auto entries = symbolTable(name, table);
+
+        if (!entries)
+            return tl::unexpected(Error::INVALID_ARCHIVE_HEADER);
+
+        for (const auto &[symbol, header]: *entries) {
+            auto it = headers.find(header);
+
+            if (it != headers.end())
+                symbols.emplace(symbol, it->second);
+        }
+    }
+
+    return Archive(std::move(buffer), std::move(members), std::move(symbols));
+}
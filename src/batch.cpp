@@ -0,0 +1,488 @@
+#include <elf/batch.h>
+#include <elf/error.h>
+#include "mapping.h"
+#include <atomic>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(IORING_OFF_SQES) && defined(__NR_io_uring_setup)
+#define ELF_IO_URING
+#endif
+
+constexpr auto HEADER_SIZE = sizeof(Elf64_Ehdr);
+
+// the header is checked from the bytes read ahead, the mapping itself is not touched
+static elf::OpenResult map(int fd, size_t length, const std::byte *header, size_t size) {
+    if (length < EI_NIDENT)
+        return tl::unexpected(elf::Error::INVALID_ELF_HEADER);
+
+    if (auto ec = elf::checkIdent(header, size))
+        return tl::unexpected(ec);
+
+    auto mapping = elf::mapFile(fd, length);
+
+    if (!mapping)
+        return tl::unexpected(mapping.error());
+
+    return elf::openMemory(std::move(mapping->buffer), mapping->length);
+}
+
+// matches what std::filesystem::file_size reports for things that are not files
+static std::error_code kind(mode_t mode) {
+    if (S_ISDIR(mode))
+        return std::make_error_code(std::errc::is_a_directory);
+
+    if (!S_ISREG(mode))
+        return std::make_error_code(std::errc::not_supported);
+
+    return {};
+}
+
+static elf::OpenResult load(const std::filesystem::path &path) {
+    struct stat st = {};
+
+    if (stat(path.c_str(), &st) < 0)
+        return tl::unexpected(std::error_code(errno, std::system_category()));
+
+    if (auto ec = kind(st.st_mode))
+        return tl::unexpected(ec);
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+        return tl::unexpected(std::error_code(errno, std::system_category()));
+
+    std::byte header[HEADER_SIZE];
+    ssize_t size = pread(fd, header, sizeof(header), 0);
+
+    elf::OpenResult result = size < 0 ?
+                             tl::unexpected(std::error_code(errno, std::system_category())) :
+                             map(fd, st.st_size, header, size);
+
+    close(fd);
+
+    return result;
+}
+
+static void pool(const std::vector<std::filesystem::path> &paths, const elf::OpenCallback &callback, size_t depth) {
+    std::mutex mutex;
+    std::atomic<size_t> next = 0;
+    std::exception_ptr exception;
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < std::min(depth, paths.size()); i++) {
+        threads.emplace_back([&]() {
+            while (true) {
+                size_t index = next++;
+
+                if (index >= paths.size())
+                    break;
+
+                auto result = load(paths[index]);
+
+                std::lock_guard<std::mutex> guard(mutex);
+
+                if (exception)
+                    break;
+
+                try {
+                    callback(index, std::move(result));
+                } catch (...) {
+                    exception = std::current_exception();
+                    next = paths.size();
+                }
+            }
+        });
+    }
+
+    for (auto &thread: threads)
+        thread.join();
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+#ifdef ELF_IO_URING
+namespace {
+    enum Operation {
+        STAT,
+        OPEN,
+        READ
+    };
+
+    struct Request {
+        struct statx stat;
+        std::byte header[HEADER_SIZE];
+        int fd = -1;
+        int statResult = 0;
+        int openResult = 0;
+        int readResult = 0;
+        unsigned int pending = 0;
+    };
+
+    // a bare submission and completion ring, only what a batch of opens needs
+    class Ring {
+    public:
+        ~Ring() {
+            if (mSQ && mSQ != MAP_FAILED)
+                munmap(mSQ, mSQSize);
+
+            if (mCQ && mCQ != MAP_FAILED && mCQ != mSQ)
+                munmap(mCQ, mCQSize);
+
+            if (mSQEs && mSQEs != MAP_FAILED)
+                munmap(mSQEs, mSQESize);
+
+            if (mFD >= 0)
+                close(mFD);
+        }
+
+    public:
+        bool setup(unsigned int entries) {
+            io_uring_params params = {};
+            mFD = (int) syscall(__NR_io_uring_setup, entries, &params);
+
+            if (mFD < 0)
+                return false;
+
+            if (!supported({IORING_OP_STATX, IORING_OP_OPENAT, IORING_OP_READ}))
+                return false;
+
+            mSQSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+            mCQSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+            if (params.features & IORING_FEAT_SINGLE_MMAP)
+                mSQSize = mCQSize = std::max(mSQSize, mCQSize);
+
+            mSQ = mmap(nullptr, mSQSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mFD, IORING_OFF_SQ_RING);
+
+            if (mSQ == MAP_FAILED)
+                return false;
+
+            mCQ = params.features & IORING_FEAT_SINGLE_MMAP ?
+                  mSQ :
+                  mmap(nullptr, mCQSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mFD, IORING_OFF_CQ_RING);
+
+            if (mCQ == MAP_FAILED)
+                return false;
+
+            mSQESize = params.sq_entries * sizeof(io_uring_sqe);
+            mSQEs = mmap(nullptr, mSQESize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mFD, IORING_OFF_SQES);
+
+            if (mSQEs == MAP_FAILED)
+                return false;
+
+            auto sq = (std::byte *) mSQ;
+            auto cq = (std::byte *) mCQ;
+
+            mSQHead = (unsigned int *) (sq + params.sq_off.head);
+            mSQTail = (unsigned int *) (sq + params.sq_off.tail);
+            mSQMask = *(unsigned int *) (sq + params.sq_off.ring_mask);
+            mSQArray = (unsigned int *) (sq + params.sq_off.array);
+            mSQEntries = params.sq_entries;
+
+            mCQHead = (unsigned int *) (cq + params.cq_off.head);
+            mCQTail = (unsigned int *) (cq + params.cq_off.tail);
+            mCQMask = *(unsigned int *) (cq + params.cq_off.ring_mask);
+            mCQEs = (io_uring_cqe *) (cq + params.cq_off.cqes);
+
+            return true;
+        }
+
+        io_uring_sqe *next(Elf64_Xword data) {
+            unsigned int tail = *mSQTail;
+
+            if (tail - __atomic_load_n(mSQHead, __ATOMIC_ACQUIRE) >= mSQEntries)
+                return nullptr;
+
+            auto sqe = (io_uring_sqe *) mSQEs + (tail & mSQMask);
+
+            *sqe = {};
+            sqe->user_data = data;
+
+            mSQArray[tail & mSQMask] = tail & mSQMask;
+            __atomic_store_n(mSQTail, tail + 1, __ATOMIC_RELEASE);
+
+            mQueued++;
+
+            return sqe;
+        }
+
+        // hands over everything queued and blocks until at least one completion is posted
+        std::error_code submit() {
+            while (true) {
+                int n = (int) syscall(__NR_io_uring_enter, mFD, mQueued, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+
+                if (n >= 0) {
+                    mQueued -= n;
+                    mSubmitted += n;
+                    return {};
+                }
+
+                if (errno != EINTR)
+                    return {errno, std::system_category()};
+            }
+        }
+
+        // waits out everything the kernel accepted, false when it cannot be waited for
+        template<typename F>
+        bool drain(F &&f) {
+            while (true) {
+                reap(f);
+
+                if (!mSubmitted)
+                    return true;
+
+                if (syscall(__NR_io_uring_enter, mFD, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR)
+                    return false;
+            }
+        }
+
+        template<typename F>
+        void reap(F &&f) {
+            unsigned int head = *mCQHead;
+
+            while (head != __atomic_load_n(mCQTail, __ATOMIC_ACQUIRE)) {
+                const auto &cqe = mCQEs[head & mCQMask];
+                Elf64_Xword data = cqe.user_data;
+                int res = cqe.res;
+
+                __atomic_store_n(mCQHead, ++head, __ATOMIC_RELEASE);
+                mSubmitted--;
+                f(data, res);
+            }
+        }
+
+    private:
+        bool supported(std::initializer_list<int> operations) {
+            std::vector<std::byte> buffer(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op));
+            auto probe = (io_uring_probe *) buffer.data();
+
+            if (syscall(__NR_io_uring_register, mFD, IORING_REGISTER_PROBE, probe, 256) < 0)
+                return false;
+
+            for (const auto &operation: operations) {
+                if (operation > probe->last_op || !(probe->ops[operation].flags & IO_URING_OP_SUPPORTED))
+                    return false;
+            }
+
+            return true;
+        }
+
+    private:
+        int mFD = -1;
+        void *mSQ = nullptr;
+        void *mCQ = nullptr;
+        void *mSQEs = nullptr;
+        size_t mSQSize = 0;
+        size_t mCQSize = 0;
+        size_t mSQESize = 0;
+        unsigned int *mSQHead = nullptr;
+        unsigned int *mSQTail = nullptr;
+        unsigned int *mSQArray = nullptr;
+        unsigned int mSQMask = 0;
+        unsigned int mSQEntries = 0;
+        unsigned int *mCQHead = nullptr;
+        unsigned int *mCQTail = nullptr;
+        unsigned int mCQMask = 0;
+        io_uring_cqe *mCQEs = nullptr;
+        unsigned int mQueued = 0;
+        unsigned int mSubmitted = 0;
+    };
+}
+
+static elf::OpenResult finish(Request &request) {
+    elf::OpenResult result = tl::unexpected(std::error_code());
+
+    if (request.statResult < 0)
+        result = tl::unexpected(std::error_code(-request.statResult, std::system_category()));
+    else if (auto ec = kind(request.stat.stx_mode))
+        result = tl::unexpected(ec);
+    else if (request.openResult < 0)
+        result = tl::unexpected(std::error_code(-request.openResult, std::system_category()));
+    else if (request.readResult < 0)
+        result = tl::unexpected(std::error_code(-request.readResult, std::system_category()));
+    else
+        result = map(request.fd, request.stat.stx_size, request.header, request.readResult);
+
+    if (request.fd >= 0)
+        close(request.fd);
+
+    request.fd = -1;
+    return result;
+}
+
+// stat and open of a file are in flight together, the header read follows as soon as the descriptor arrives
+static bool uring(const std::vector<std::filesystem::path> &paths, const elf::OpenCallback &callback, size_t depth) {
+    std::vector<Request> requests(paths.size());
+    Ring ring;
+
+    // every file holds at most two submissions, and the completion ring is twice the submission ring
+    if (!ring.setup(std::min<size_t>(depth * 2, 4096)))
+        return false;
+
+    depth = std::min<size_t>(depth, 2048);
+
+    size_t next = 0;
+    size_t done = 0;
+    size_t inflight = 0;
+
+    auto complete = [&](size_t index) {
+        inflight--;
+        done++;
+        callback(index, finish(requests[index]));
+    };
+
+    auto handle = [&](Elf64_Xword data, int res) {
+        size_t index = data >> 2;
+        auto &request = requests[index];
+
+        switch (data & 3) {
+            case STAT:
+                request.statResult = res;
+                break;
+
+            case OPEN:
+                request.openResult = res;
+
+                if (res >= 0) {
+                    request.fd = res;
+
+                    auto read = ring.next(index << 2 | READ);
+                    read->opcode = IORING_OP_READ;
+                    read->fd = res;
+                    read->addr = (Elf64_Xword) request.header;
+                    read->len = sizeof(request.header);
+                    read->off = 0;
+
+                    request.pending++;
+                }
+
+                break;
+
+            case READ:
+                request.readResult = res;
+                break;
+
+            default:
+                break;
+        }
+
+        if (!--request.pending)
+            complete(index);
+    };
+
+    // the kernel still writes into requests until its completions are posted, so they are waited out before leaving
+    auto abandon = [&]() {
+        bool drained = ring.drain([&](Elf64_Xword data, int res) {
+            if ((data & 3) == OPEN && res >= 0)
+                requests[data >> 2].fd = res;
+        });
+
+        for (auto &request: requests) {
+            if (request.fd >= 0)
+                close(request.fd);
+
+            request.fd = -1;
+        }
+
+        // nothing tells when the kernel is done with them, better leaked than overwritten after free
+        if (!drained)
+            new std::vector<Request>(std::move(requests));
+    };
+
+    try {
+        while (done < paths.size()) {
+            for (; inflight < depth && next < paths.size(); next++, inflight++) {
+                auto &request = requests[next];
+
+                auto stat = ring.next(next << 2 | STAT);
+                stat->opcode = IORING_OP_STATX;
+                stat->fd = AT_FDCWD;
+                stat->addr = (Elf64_Xword) paths[next].c_str();
+                stat->len = STATX_TYPE | STATX_SIZE;
+                stat->off = (Elf64_Xword) &request.stat;
+
+                auto open = ring.next(next << 2 | OPEN);
+                open->opcode = IORING_OP_OPENAT;
+                open->fd = AT_FDCWD;
+                open->addr = (Elf64_Xword) paths[next].c_str();
+                open->open_flags = O_RDONLY | O_CLOEXEC;
+
+                request.pending = 2;
+            }
+
+            if (auto ec = ring.submit()) {
+                std::vector<size_t> failed;
+
+                for (size_t i = 0; i < paths.size(); i++) {
+                    if (i >= next || requests[i].pending)
+                        failed.push_back(i);
+                }
+
+                abandon();
+
+                // nothing more will complete, so whatever is still open is reported failed
+                for (const auto &index: failed)
+                    callback(index, tl::unexpected(ec));
+
+                return true;
+            }
+
+            ring.reap(handle);
+        }
+    } catch (...) {
+        abandon();
+        throw;
+    }
+
+    return true;
+}
+#endif
+
+void elf::openFiles(const std::vector<std::filesystem::path> &paths, const OpenCallback &callback, size_t depth) {
+    if (paths.empty())
+        return;
+
+    depth = std::max<size_t>(depth, 1);
+
+#ifdef ELF_IO_URING
+    // rings are refused by old kernels and by seccomp profiles of most container runtimes
+    if (uring(paths, callback, depth))
+        return;
+#endif
+
+    pool(paths, callback, depth);
+}
+
+elf::OpenBatch elf::openFiles(std::vector<std::filesystem::path> paths, size_t depth) {
+    std::vector<std::promise<OpenResult>> promises(paths.size());
+    OpenBatch batch;
+
+    for (auto &promise: promises)
+        batch.futures.push_back(promise.get_future());
+
+    // the worker owns the paths and the promises, the batch joins it
+    batch.worker = std::async(
+            std::launch::async,
+            [paths = std::move(paths), promises = std::move(promises), depth]() mutable {
+                openFiles(
+                        paths,
+                        [&](size_t index, OpenResult result) {
+                            promises[index].set_value(std::move(result));
+                        },
+                        depth
+                );
+            }
+    );
+
+    return batch;
+}
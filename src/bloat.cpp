@@ -0,0 +1,276 @@
+#include <elf/bloat.h>
+#include <elf/symbol.h>
+#include <algorithm>
+#include <map>
+
+constexpr auto PADDING = "[padding]";
+constexpr auto UNASSIGNED = "[unassigned]";
+constexpr auto UNKNOWN_UNIT = "[unknown]";
+constexpr auto OTHER_PREFIX = "[other]";
+
+namespace {
+    struct Item {
+        Elf64_Addr begin;
+        Elf64_Addr end;
+        std::string_view name;
+        size_t unit;
+    };
+
+    class Totals {
+    public:
+        void add(std::string_view name, Elf64_Xword fileSize, Elf64_Xword vmSize) {
+            if (!fileSize && !vmSize)
+                return;
+
+            auto it = mEntries.find(name);
+
+            if (it == mEntries.end())
+                it = mEntries.emplace(std::string(name), elf::SizeEntry{std::string(name), 0, 0}).first;
+
+            it->second.fileSize += fileSize;
+            it->second.vmSize += vmSize;
+        }
+
+        std::vector<elf::SizeEntry> sorted() {
+            std::vector<elf::SizeEntry> entries;
+
+            for (auto &[name, entry]: mEntries)
+                entries.push_back(std::move(entry));
+
+            std::sort(
+                    entries.begin(),
+                    entries.end(),
+                    [](const auto &lhs, const auto &rhs) {
+                        if (lhs.vmSize != rhs.vmSize)
+                            return lhs.vmSize > rhs.vmSize;
+
+                        return lhs.name < rhs.name;
+                    }
+            );
+
+            return entries;
+        }
+
+    private:
+        std::map<std::string, elf::SizeEntry, std::less<>> mEntries;
+    };
+
+    // accumulates byte ranges into every level at once, nothing is kept per byte
+    class Attribution {
+    public:
+        explicit Attribution(const std::vector<std::string> &prefixes) : mPrefixes(prefixes) {
+
+        }
+
+    public:
+        void add(std::string_view symbol, std::string_view unit, Elf64_Xword fileSize, Elf64_Xword vmSize) {
+            symbols.add(symbol, fileSize, vmSize);
+            units.add(unit, fileSize, vmSize);
+            prefixes.add(prefix(symbol, unit), fileSize, vmSize);
+        }
+
+    private:
+        std::string_view prefix(std::string_view symbol, std::string_view unit) {
+            if (unit == PADDING || unit == UNASSIGNED)
+                return unit;
+
+            std::string_view match = OTHER_PREFIX;
+            size_t length = 0;
+
+            for (const auto &prefix: mPrefixes) {
+                if (prefix.size() >= length && symbol.substr(0, prefix.size()) == prefix) {
+                    match = prefix;
+                    length = prefix.size();
+                }
+            }
+
+            return match;
+        }
+
+    public:
+        Totals symbols;
+        Totals units;
+        Totals prefixes;
+
+    private:
+        const std::vector<std::string> &mPrefixes;
+    };
+}
+
+static bool partitioned(elf::ISection &section) {
+    // .tbss only exists in the tls template and overlaps the sections after it
+    if ((section.flags() & SHF_TLS) && section.type() == SHT_NOBITS)
+        return false;
+
+    return (section.flags() & SHF_ALLOC) && section.size();
+}
+
+static std::vector<std::vector<Item>> items(const elf::Reader &reader, std::vector<std::string_view> &units) {
+    const auto &sections = reader.sections();
+    std::vector<std::vector<Item>> items(sections.size());
+
+    auto table = reader.section(".symtab");
+
+    if (!table || table->type() != SHT_SYMTAB)
+        table = reader.section(".dynsym");
+
+    if (!table || table->type() == SHT_NOBITS)
+        return items;
+
+    bool relocatable = reader.header()->type() == ET_REL;
+    size_t unit = SIZE_MAX;
+
+    for (const auto &symbol: elf::SymbolTable(reader, table).views()) {
+        unsigned char type = ELF64_ST_TYPE(symbol.info);
+
+        if (type == STT_FILE) {
+            unit = units.size();
+            units.push_back(symbol.name);
+            continue;
+        }
+
+        if (type != STT_FUNC && type != STT_GNU_IFUNC && type != STT_OBJECT && type != STT_NOTYPE)
+            continue;
+
+        if (!symbol.size || symbol.name.empty() || symbol.sectionIndex == SHN_UNDEF ||
+            symbol.sectionIndex >= sections.size())
+            continue;
+
+        Elf64_Addr begin = relocatable ? sections[symbol.sectionIndex]->address() + symbol.value : symbol.value;
+
+        items[symbol.sectionIndex].push_back({
+                begin,
+                begin + symbol.size,
+                symbol.name,
+                ELF64_ST_BIND(symbol.info) == STB_LOCAL ? unit : SIZE_MAX
+        });
+    }
+
+    return items;
+}
+
+elf::SizeReport elf::sizeReport(const Reader &reader, const std::vector<std::string> &prefixes) {
+    SizeReport report;
+    Attribution attribution(prefixes);
+    Totals sectionTotals;
+
+    std::vector<std::string_view> units;
+    auto symbols = items(reader, units);
+
+    const auto &sections = reader.sections();
+
+    for (size_t i = 0; i < sections.size(); i++) {
+        auto &section = *sections[i];
+
+        if (!partitioned(section))
+            continue;
+
+        bool nobits = section.type() == SHT_NOBITS;
+        Elf64_Addr begin = section.address();
+        Elf64_Addr end = begin + section.size();
+
+        sectionTotals.add(section.name(), nobits ? 0 : section.size(), section.size());
+
+        auto &list = symbols[i];
+
+        // widest first at equal addresses so aliases and nested symbols fall into the outer one
+        std::sort(
+                list.begin(),
+                list.end(),
+                [](const auto &lhs, const auto &rhs) {
+                    if (lhs.begin != rhs.begin)
+                        return lhs.begin < rhs.begin;
+
+                    return lhs.end > rhs.end;
+                }
+        );
+
+        Elf64_Addr cursor = begin;
+        size_t last = SIZE_MAX;
+
+        // bytes no symbol covers are kept apart per section
+        std::string padding = "[padding " + section.name() + "]";
+
+        auto attribute = [&](std::string_view name, std::string_view unit, Elf64_Addr from, Elf64_Addr to) {
+            attribution.add(name, unit, nobits ? 0 : to - from, to - from);
+        };
+
+        for (const auto &item: list) {
+            Elf64_Addr from = std::max(item.begin, cursor);
+            Elf64_Addr to = std::min(item.end, end);
+
+            if (from >= to)
+                continue;
+
+            if (from > cursor)
+                attribute(padding, PADDING, cursor, from);
+
+            // symbols without a file of their own belong to the unit laid out before them
+            size_t unit = item.unit != SIZE_MAX ? item.unit : last;
+            last = unit;
+
+            attribute(item.name, unit != SIZE_MAX ? units[unit] : UNKNOWN_UNIT, from, to);
+            cursor = to;
+        }
+
+        if (cursor < end)
+            attribute(padding, PADDING, cursor, end);
+    }
+
+    Totals segmentTotals;
+    size_t index = 0;
+
+    for (const auto &segment: reader.segments()) {
+        if (segment->type() != PT_LOAD)
+            continue;
+
+        Elf64_Addr begin = segment->virtualAddress();
+        Elf64_Addr end = begin + segment->memorySize();
+        Elf64_Addr fileEnd = begin + std::min(segment->fileSize(), segment->memorySize());
+
+        segmentTotals.add("LOAD #" + std::to_string(index++), segment->fileSize(), segment->memorySize());
+
+        std::vector<std::pair<Elf64_Addr, Elf64_Addr>> covered;
+
+        for (const auto &section: sections) {
+            if (!partitioned(*section))
+                continue;
+
+            Elf64_Addr from = std::max(section->address(), begin);
+            Elf64_Addr to = std::min(section->address() + section->size(), end);
+
+            if (from < to)
+                covered.emplace_back(from, to);
+        }
+
+        std::sort(covered.begin(), covered.end());
+
+        // headers and alignment between sections still occupy the mapping
+        Elf64_Addr cursor = begin;
+
+        auto gap = [&](Elf64_Addr from, Elf64_Addr to) {
+            Elf64_Xword fileSize = from < fileEnd ? std::min(to, fileEnd) - from : 0;
+
+            sectionTotals.add(UNASSIGNED, fileSize, to - from);
+            attribution.add(UNASSIGNED, UNASSIGNED, fileSize, to - from);
+        };
+
+        for (const auto &[from, to]: covered) {
+            if (from > cursor)
+                gap(cursor, from);
+
+            cursor = std::max(cursor, to);
+        }
+
+        if (cursor < end)
+            gap(cursor, end);
+    }
+
+    report.segments = segmentTotals.sorted();
+    report.sections = sectionTotals.sorted();
+    report.symbols = attribution.symbols.sorted();
+    report.units = attribution.units.sorted();
+    report.prefixes = attribution.prefixes.sorted();
+
+    return report;
+}
@@ -0,0 +1,69 @@
+#include <elf/cache.h>
+
+static bool same(const struct stat &st, off_t size, const timespec &modified) {
+    return st.st_size == size &&
+           st.st_mtim.tv_sec == modified.tv_sec &&
+           st.st_mtim.tv_nsec == modified.tv_nsec;
+}
+
+tl::expected<elf::Reader, std::error_code> elf::ReaderCache::open(const std::filesystem::path &path) {
+    struct stat st = {};
+
+    if (stat(path.string().c_str(), &st) < 0)
+        return tl::unexpected(std::error_code(errno, std::system_category()));
+
+    std::pair<dev_t, ino_t> key = {st.st_dev, st.st_ino};
+
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        auto it = mInodes.find(key);
+
+        if (it != mInodes.end() && same(st, it->second.size, it->second.modified))
+            return it->second.reader;
+    }
+
+    auto reader = openFile(path);
+
+    if (!reader)
+        return tl::unexpected(reader.error());
+
+    std::lock_guard<std::mutex> guard(mMutex);
+    auto it = mInodes.find(key);
+
+    // another thread may have opened the same file meanwhile
+    if (it != mInodes.end() && same(st, it->second.size, it->second.modified))
+        return it->second.reader;
+
+    mInodes.insert_or_assign(key, Entry{*reader, st.st_size, st.st_mtim});
+
+    return *reader;
+}
+
+void elf::ReaderCache::erase(const std::filesystem::path &path) {
+    struct stat st = {};
+
+    if (stat(path.string().c_str(), &st) < 0)
+        return;
+
+    std::lock_guard<std::mutex> guard(mMutex);
+    auto it = mInodes.find({st.st_dev, st.st_ino});
+
+    if (it == mInodes.end())
+        return;
+
+    mInodes.erase(it);
+}
+
+void elf::ReaderCache::clear() {
+    std::lock_guard<std::mutex> guard(mMutex);
+    mInodes.clear();
+}
+
+elf::ReaderCache &elf::readerCache() {
+    static ReaderCache instance;
+    return instance;
+}
+
+tl::expected<elf::Reader, std::error_code> elf::openCachedFile(const std::filesystem::path &path) {
+    return readerCache().open(path);
+}
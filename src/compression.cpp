@@ -0,0 +1,196 @@
+#include <elf/compression.h>
+#include <elf/error.h>
+#include "cursor.h"
+#include <zlib.h>
+#include <zstd.h>
+
+#ifndef ELFCOMPRESS_ZSTD
+#define ELFCOMPRESS_ZSTD 2
+#endif
+
+constexpr auto DEFAULT_DECOMPRESSION_BUDGET = 256 * 1024 * 1024;
+
+elf::DecompressionCache::DecompressionCache(size_t budget) : mBudget(budget), mBytes(0), mGeneration(0) {
+
+}
+
+tl::expected<elf::Buffer, std::error_code>
+elf::DecompressionCache::get(const Reader &reader, const std::shared_ptr<ISection> &section) {
+    if (!(section->flags() & SHF_COMPRESSED))
+        return Buffer{reader.buffer(), section->data(), section->size()};
+
+    const std::byte *key = section->data();
+
+    std::promise<Result> promise;
+    std::shared_future<Result> future;
+    std::optional<size_t> id;
+
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        auto it = mEntries.find(key);
+
+        // the key is only meaningful while the mapping it points into is alive
+        if (it != mEntries.end() && !it->second.owner.expired()) {
+            mLRU.splice(mLRU.begin(), mLRU, it->second.position);
+            future = it->second.future;
+        } else {
+            if (it != mEntries.end()) {
+                mBytes -= it->second.size;
+                mLRU.erase(it->second.position);
+                mEntries.erase(it);
+            }
+
+            id = mGeneration++;
+            future = promise.get_future().share();
+
+            mLRU.push_front(key);
+            mEntries.emplace(key, Entry{*id, reader.buffer(), future, 0, mLRU.begin()});
+        }
+    }
+
+    if (id) {
+        tl::expected<std::vector<std::byte>, std::error_code> data = tl::unexpected(std::error_code());
+        std::exception_ptr exception;
+
+        // waiters must never be left with a broken promise, a forged size can make the allocation throw
+        try {
+            data = decompress(reader, *section);
+        } catch (const std::bad_alloc &) {
+            data = tl::unexpected(std::make_error_code(std::errc::not_enough_memory));
+        } catch (const std::length_error &) {
+            data = tl::unexpected(std::make_error_code(std::errc::not_enough_memory));
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        if (exception)
+            promise.set_exception(exception);
+        else if (data)
+            promise.set_value(std::make_shared<const std::vector<std::byte>>(std::move(*data)));
+        else
+            promise.set_value(tl::unexpected(data.error()));
+
+        std::lock_guard<std::mutex> guard(mMutex);
+        auto it = mEntries.find(key);
+
+        // the entry may have been cleared or replaced meanwhile
+        if (it != mEntries.end() && it->second.id == *id) {
+            if (!exception && data) {
+                it->second.size = (*future.get())->size();
+                mBytes += it->second.size;
+                evict();
+            } else {
+                mLRU.erase(it->second.position);
+                mEntries.erase(it);
+            }
+        }
+    }
+
+    const auto &result = future.get();
+
+    if (!result)
+        return tl::unexpected(result.error());
+
+    return Buffer{*result, (*result)->data(), (*result)->size()};
+}
+
+size_t elf::DecompressionCache::bytes() {
+    std::lock_guard<std::mutex> guard(mMutex);
+    return mBytes;
+}
+
+void elf::DecompressionCache::clear() {
+    std::lock_guard<std::mutex> guard(mMutex);
+
+    size_t budget = mBudget;
+
+    mBudget = 0;
+    evict();
+    mBudget = budget;
+}
+
+void elf::DecompressionCache::evict() {
+    auto it = mLRU.end();
+
+    while (mBytes > mBudget && it != mLRU.begin()) {
+        it--;
+
+        auto entry = mEntries.find(*it);
+
+        // leave in-flight decompressions to their owners
+        if (entry->second.future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            continue;
+
+        mBytes -= entry->second.size;
+        mEntries.erase(entry);
+        it = mLRU.erase(it);
+    }
+}
+
+elf::DecompressionCache &elf::decompressionCache() {
+    static DecompressionCache instance(DEFAULT_DECOMPRESSION_BUDGET);
+    return instance;
+}
+
+tl::expected<std::vector<std::byte>, std::error_code> elf::decompress(const Reader &reader, ISection &section) {
+    auto header = reader.header();
+
+    Cursor cursor(
+            section.data(),
+            section.size(),
+            header->ident()[EI_DATA] == ELFDATA2LSB ? endian::Little : endian::Big
+    );
+
+    Elf64_Word type;
+    Elf64_Xword size;
+
+    if (header->ident()[EI_CLASS] == ELFCLASS64) {
+        type = cursor.read<Elf64_Word>();
+        cursor.read<Elf64_Word>();
+        size = cursor.read<Elf64_Xword>();
+        cursor.read<Elf64_Xword>();
+    } else {
+        type = cursor.read<Elf32_Word>();
+        size = cursor.read<Elf32_Word>();
+        cursor.read<Elf32_Word>();
+    }
+
+    if (cursor.failed())
+        return tl::unexpected(Error::INVALID_COMPRESSION_HEADER);
+
+    // reject sizes no valid stream could expand to before allocating them
+    if (type == ELFCOMPRESS_ZLIB && size / 1032 > cursor.remaining())
+        return tl::unexpected(Error::INVALID_COMPRESSION_HEADER);
+
+    if (type == ELFCOMPRESS_ZSTD && ZSTD_getFrameContentSize(cursor.current(), cursor.remaining()) != size)
+        return tl::unexpected(Error::INVALID_COMPRESSION_HEADER);
+
+    std::vector<std::byte> buffer(size);
+
+    if (type == ELFCOMPRESS_ZLIB) {
+        uLongf length = size;
+
+        int status = uncompress(
+                (Bytef *) buffer.data(),
+                &length,
+                (const Bytef *) cursor.current(),
+                cursor.remaining()
+        );
+
+        if (status != Z_OK || length != size)
+            return tl::unexpected(Error::DECOMPRESSION_FAILED);
+    } else if (type == ELFCOMPRESS_ZSTD) {
+        size_t length = ZSTD_decompress(buffer.data(), size, cursor.current(), cursor.remaining());
+
+        if (ZSTD_isError(length) || length != size)
+            return tl::unexpected(Error::DECOMPRESSION_FAILED);
+    } else {
+        return tl::unexpected(Error::UNSUPPORTED_COMPRESSION);
+    }
+
+    return buffer;
+}
+
+tl::expected<elf::Buffer, std::error_code> elf::sectionData(const Reader &reader, const std::shared_ptr<ISection> &section) {
+    return decompressionCache().get(reader, section);
+}
@@ -0,0 +1,155 @@
+#ifndef ELF_CURSOR_H
+#define ELF_CURSOR_H
+
+#include <elf/endian.h>
+#include <elf.h>
+#include <cstring>
+#include <string_view>
+
+namespace elf {
+    // bounds-checked sequential reader over mapped bytes, reads past the end yield zero and set failed()
+    class Cursor {
+    public:
+        Cursor(const std::byte *data, size_t size, endian::Type endian)
+                : mData(data), mSize(size), mOffset(0), mEndian(endian), mFailed(false) {
+
+        }
+
+    public:
+        template<typename T>
+        T read() {
+            if (mSize - mOffset < sizeof(T)) {
+                mFailed = true;
+                mOffset = mSize;
+                return 0;
+            }
+
+            T value;
+            memcpy(&value, mData + mOffset, sizeof(T));
+            mOffset += sizeof(T);
+
+            return mEndian == endian::Little ?
+                   endian::convert<endian::Little>(value) :
+                   endian::convert<endian::Big>(value);
+        }
+
+        Elf64_Xword unsignedLEB128() {
+            Elf64_Xword value = 0;
+
+            for (unsigned int shift = 0; mOffset < mSize; shift += 7) {
+                auto byte = (unsigned char) mData[mOffset++];
+
+                if (shift < 64)
+                    value |= (Elf64_Xword) (byte & 0x7f) << shift;
+
+                if (!(byte & 0x80))
+                    return value;
+            }
+
+            mFailed = true;
+            return value;
+        }
+
+        Elf64_Sxword signedLEB128() {
+            Elf64_Xword value = 0;
+
+            for (unsigned int shift = 0; mOffset < mSize;) {
+                auto byte = (unsigned char) mData[mOffset++];
+
+                if (shift < 64)
+                    value |= (Elf64_Xword) (byte & 0x7f) << shift;
+
+                shift += 7;
+
+                if (!(byte & 0x80)) {
+                    if (shift < 64 && (byte & 0x40))
+                        value |= ~(Elf64_Xword) 0 << shift;
+
+                    return (Elf64_Sxword) value;
+                }
+            }
+
+            mFailed = true;
+            return (Elf64_Sxword) value;
+        }
+
+        std::string_view string() {
+            if (mOffset >= mSize) {
+                mFailed = true;
+                return {};
+            }
+
+            auto str = (const char *) mData + mOffset;
+            size_t length = strnlen(str, mSize - mOffset);
+
+            if (length == mSize - mOffset) {
+                mFailed = true;
+                mOffset = mSize;
+                return {};
+            }
+
+            mOffset += length + 1;
+            return {str, length};
+        }
+
+        const std::byte *skip(size_t length) {
+            const std::byte *current = this->current();
+
+            if (mSize - mOffset < length) {
+                mFailed = true;
+                mOffset = mSize;
+                return current;
+            }
+
+            mOffset += length;
+            return current;
+        }
+
+        void seek(size_t offset) {
+            if (offset > mSize) {
+                mFailed = true;
+                offset = mSize;
+            }
+
+            mOffset = offset;
+        }
+
+    public:
+        [[nodiscard]] const std::byte *data() const {
+            return mData;
+        }
+
+        [[nodiscard]] const std::byte *current() const {
+            return mData + mOffset;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return mSize;
+        }
+
+        [[nodiscard]] size_t offset() const {
+            return mOffset;
+        }
+
+        [[nodiscard]] size_t remaining() const {
+            return mSize - mOffset;
+        }
+
+        [[nodiscard]] endian::Type endian() const {
+            return mEndian;
+        }
+
+        [[nodiscard]] bool failed() const {
+            return mFailed;
+        }
+
+    private:
+        const std::byte *mData;
+        size_t mSize;
+        size_t mOffset;
+        endian::Type mEndian;
+        bool mFailed;
+    };
+}
+
+#endif //ELF_CURSOR_H
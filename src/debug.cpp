@@ -0,0 +1,273 @@
+#include <elf/debug.h>
+#include <elf/minidebug.h>
+#include <elf/note.h>
+#include <elf/error.h>
+#include "cursor.h"
+#include <zlib.h>
+#include <algorithm>
+
+static std::string hex(const std::vector<std::byte> &bytes) {
+    constexpr auto DIGITS = "0123456789abcdef";
+
+    std::string result;
+
+    for (const auto &byte: bytes) {
+        result.push_back(DIGITS[std::to_integer<unsigned>(byte) >> 4]);
+        result.push_back(DIGITS[std::to_integer<unsigned>(byte) & 0xf]);
+    }
+
+    return result;
+}
+
+static bool present(const std::shared_ptr<elf::ISection> &section) {
+    return section->type() != SHT_NOBITS && section->type() != SHT_NULL && section->size() > 0;
+}
+
+// the file may have changed since it was mapped, only the mapped bytes are safe to read
+static std::optional<Elf64_Word> checksum(const elf::Reader &reader) {
+    size_t length = reader.length();
+
+    if (!length)
+        return std::nullopt;
+
+    auto data = (const Bytef *) reader.buffer().get();
+    uLong crc = crc32(0, nullptr, 0);
+
+    // zlib takes 32-bit lengths
+    while (length > 0) {
+        auto chunk = (uInt) std::min<size_t>(length, 1 << 30);
+
+        crc = crc32(crc, data, chunk);
+        data += chunk;
+        length -= chunk;
+    }
+
+    return (Elf64_Word) crc;
+}
+
+elf::DebugObject::DebugObject(Reader binary, std::optional<Reader> debug)
+        : mBinary(std::move(binary)), mDebug(std::move(debug)) {
+
+}
+
+const elf::Reader &elf::DebugObject::binary() const {
+    return mBinary;
+}
+
+const std::optional<elf::Reader> &elf::DebugObject::debug() const {
+    return mDebug;
+}
+
+std::optional<elf::DebugSection> elf::DebugObject::section(std::string_view name) const {
+    auto section = mBinary.section(name);
+
+    if (section && present(section))
+        return DebugSection{mBinary, section};
+
+    if (mDebug) {
+        auto debug = mDebug->section(name);
+
+        if (debug && present(debug))
+            return DebugSection{*mDebug, debug};
+    }
+
+    if (!section)
+        return std::nullopt;
+
+    return DebugSection{mBinary, section};
+}
+
+std::vector<elf::DebugSection> elf::DebugObject::sections() const {
+    std::vector<DebugSection> sections;
+
+    for (const auto &section: mBinary.sections())
+        sections.push_back({mBinary, section});
+
+    if (!mDebug)
+        return sections;
+
+    // fill in stripped contents, then append what only the debug file has
+    for (const auto &debug: mDebug->sections()) {
+        if (!present(debug))
+            continue;
+
+        auto it = std::find_if(
+                sections.begin(),
+                sections.end(),
+                [name = debug->name()](const auto &section) {
+                    return section.section->name() == name;
+                }
+        );
+
+        if (it == sections.end())
+            sections.push_back({*mDebug, debug});
+        else if (!present(it->section))
+            *it = {*mDebug, debug};
+    }
+
+    return sections;
+}
+
+std::optional<elf::SymbolTable> elf::DebugObject::symbols() const {
+    auto symtab = section(".symtab");
+
+    if (symtab && present(symtab->section))
+        return SymbolTable(symtab->reader, symtab->section);
+
+    auto dynsym = mBinary.section(".dynsym");
+
+    if (!dynsym || !present(dynsym))
+        return std::nullopt;
+
+    return SymbolTable(mBinary, dynsym);
+}
+
+elf::DebugResolver::DebugResolver(std::vector<std::filesystem::path> directories)
+        : mDirectories(std::move(directories)) {
+
+}
+
+std::optional<elf::Reader> elf::DebugResolver::resolve(const Reader &binary, const std::filesystem::path &path) {
+    std::string key;
+    auto id = buildID(binary);
+
+    if (id) {
+        key = hex(*id);
+    } else if (auto link = debugLink(binary)) {
+        std::error_code ec;
+        auto canonical = std::filesystem::weakly_canonical(path, ec);
+
+        key = (ec ? path : canonical).string() + ':' + link->first + ':' + std::to_string(link->second);
+    } else {
+        return std::nullopt;
+    }
+
+    std::optional<std::optional<std::filesystem::path>> cached;
+
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        auto it = mCache.find(key);
+
+        if (it != mCache.end())
+            cached = it->second;
+    }
+
+    if (cached && !*cached)
+        return std::nullopt;
+
+    if (cached) {
+        auto reader = openFile(**cached);
+
+        // a debug file replaced or removed since is looked up again
+        if (reader && (!id || buildID(*reader) == id))
+            return std::move(*reader);
+    }
+
+    auto debug = search(binary, path);
+
+    std::lock_guard<std::mutex> guard(mMutex);
+    mCache.insert_or_assign(key, debug ? std::optional(debug->first) : std::nullopt);
+
+    if (!debug)
+        return std::nullopt;
+
+    return std::move(debug->second);
+}
+
+tl::expected<elf::DebugObject, std::error_code> elf::DebugResolver::open(const std::filesystem::path &path) {
+    auto reader = openFile(path);
+
+    if (!reader)
+        return tl::unexpected(reader.error());
+
+    auto debug = resolve(*reader, path);
+
+    // stripped distribution binaries may still carry their function symbols inline
+    if (!debug)
+        debug = miniDebugInfo(*reader);
+
+    return DebugObject(std::move(*reader), std::move(debug));
+}
+
+std::optional<std::pair<std::filesystem::path, elf::Reader>>
+elf::DebugResolver::search(const Reader &binary, const std::filesystem::path &path) {
+    auto id = buildID(binary);
+
+    if (id && id->size() > 1) {
+        std::string name = hex(*id);
+
+        for (const auto &directory: mDirectories) {
+            auto candidate = directory / ".build-id" / name.substr(0, 2) / (name.substr(2) + ".debug");
+
+            if (!std::filesystem::exists(candidate))
+                continue;
+
+            auto reader = openFile(candidate);
+
+            if (reader && buildID(*reader) == id)
+                return std::pair{candidate, std::move(*reader)};
+        }
+    }
+
+    auto link = debugLink(binary);
+
+    if (!link)
+        return std::nullopt;
+
+    std::error_code ec;
+    auto directory = std::filesystem::weakly_canonical(path, ec).parent_path();
+
+    if (ec)
+        directory = std::filesystem::absolute(path, ec).parent_path();
+
+    std::vector<std::filesystem::path> candidates = {
+            directory / link->first,
+            directory / ".debug" / link->first
+    };
+
+    for (const auto &root: mDirectories)
+        candidates.push_back(root / directory.relative_path() / link->first);
+
+    for (const auto &candidate: candidates) {
+        // a debuglink naming the binary itself is common when it was never stripped
+        if (std::filesystem::equivalent(candidate, path, ec) || !std::filesystem::exists(candidate))
+            continue;
+
+        auto reader = openFile(candidate);
+
+        if (!reader)
+            continue;
+
+        if (id && buildID(*reader) != id)
+            continue;
+
+        if (checksum(*reader) == link->second)
+            return std::pair{candidate, std::move(*reader)};
+    }
+
+    return std::nullopt;
+}
+
+std::optional<std::pair<std::string, Elf64_Word>> elf::debugLink(const Reader &reader) {
+    auto section = reader.section(".gnu_debuglink");
+
+    if (!section || !present(section))
+        return std::nullopt;
+
+    Cursor cursor(
+            section->data(),
+            section->size(),
+            reader.header()->ident()[EI_DATA] == ELFDATA2LSB ? endian::Little : endian::Big
+    );
+
+    std::string name(cursor.string());
+
+    // the checksum is aligned to 4 bytes after the terminating nul
+    cursor.seek((cursor.offset() + 3) & ~3);
+    auto crc = cursor.read<Elf64_Word>();
+
+    if (cursor.failed() || name.empty())
+        return std::nullopt;
+
+    return std::pair{name, crc};
+}
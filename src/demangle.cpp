@@ -0,0 +1,125 @@
+#include <elf/demangle.h>
+#include <cxxabi.h>
+#include <atomic>
+#include <cstring>
+
+constexpr auto SHARD_COUNT = 64;
+constexpr auto ARENA_BLOCK_SIZE = 64 * 1024;
+constexpr auto PARALLEL_CHUNK = 1024;
+
+// reuses one malloc'd output buffer per thread instead of letting every call allocate its own
+static const char *demangled(std::string_view name) {
+    thread_local std::string input;
+    thread_local std::unique_ptr<char, decltype(&free)> buffer(nullptr, &free);
+    thread_local size_t length = 0;
+
+    if (name.substr(0, 2) != "_Z")
+        return nullptr;
+
+    // string table entries may run into the end of the section, so terminate a copy
+    input.assign(name);
+
+    int status = 0;
+    char *output = abi::__cxa_demangle(input.c_str(), buffer.get(), buffer ? &length : nullptr, &status);
+
+    if (status != 0 || !output)
+        return nullptr;
+
+    if (output != buffer.get()) {
+        buffer.release();
+        buffer.reset(output);
+        length = strlen(output) + 1;
+    }
+
+    return output;
+}
+
+elf::Demangler::Demangler(SymbolTable table) : mTable(std::move(table)), mShards(std::make_unique<Shard[]>(SHARD_COUNT)) {
+    for (size_t i = 0; i < SHARD_COUNT; i++) {
+        mShards[i].block = nullptr;
+        mShards[i].used = ARENA_BLOCK_SIZE;
+    }
+}
+
+std::string_view elf::Demangler::name(size_t index) {
+    return name(mTable.view(index));
+}
+
+std::string_view elf::Demangler::name(const SymbolView &symbol) {
+    if (symbol.name.substr(0, 2) != "_Z")
+        return symbol.name;
+
+    auto &shard = mShards[symbol.nameIndex % SHARD_COUNT];
+    std::lock_guard<std::mutex> guard(shard.mutex);
+
+    auto it = shard.names.find(symbol.nameIndex);
+
+    if (it != shard.names.end())
+        return it->second;
+
+    // names that fail to demangle are remembered as they are, so they are not retried
+    const char *output = demangled(symbol.name);
+    std::string_view result = output ? store(shard, output) : symbol.name;
+
+    shard.names.emplace(symbol.nameIndex, result);
+    return result;
+}
+
+void elf::Demangler::demangle(size_t concurrency) {
+    size_t count = mTable.size();
+    size_t chunks = (count + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+
+    std::atomic<size_t> next = 0;
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < std::min(std::max<size_t>(concurrency, 1), std::max<size_t>(chunks, 1)); i++) {
+        threads.emplace_back([&]() {
+            while (true) {
+                size_t begin = next.fetch_add(PARALLEL_CHUNK);
+
+                if (begin >= count)
+                    break;
+
+                auto views = mTable.views();
+                auto it = views.begin() + (std::ptrdiff_t) begin;
+
+                for (size_t index = begin; index < std::min(count, begin + PARALLEL_CHUNK); index++, ++it)
+                    name(*it);
+            }
+        });
+    }
+
+    for (auto &thread: threads)
+        thread.join();
+}
+
+std::string_view elf::Demangler::store(Shard &shard, std::string_view name) {
+    char *data;
+
+    if (name.size() > ARENA_BLOCK_SIZE / 4) {
+        // oversized names get a block of their own and leave the current one open
+        shard.blocks.push_back(std::make_unique<char[]>(name.size()));
+        data = shard.blocks.back().get();
+    } else {
+        if (ARENA_BLOCK_SIZE - shard.used < name.size()) {
+            shard.blocks.push_back(std::make_unique<char[]>(ARENA_BLOCK_SIZE));
+            shard.block = shard.blocks.back().get();
+            shard.used = 0;
+        }
+
+        data = shard.block + shard.used;
+        shard.used += name.size();
+    }
+
+    memcpy(data, name.data(), name.size());
+    return {data, name.size()};
+}
+
+std::optional<std::string> elf::demangle(std::string_view name) {
+    const char *output = demangled(name);
+
+    if (!output)
+        return std::nullopt;
+
+    return output;
+}
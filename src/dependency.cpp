@@ -0,0 +1,549 @@
+#include <elf/dependency.h>
+#include <elf/dynamic.h>
+#include <elf/symbol.h>
+#include "cursor.h"
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#ifndef VERSYM_HIDDEN
+#define VERSYM_HIDDEN 0x8000
+#endif
+
+constexpr auto MAX_SYMLINKS = 40;
+
+namespace {
+    struct Export {
+        std::string_view version;
+        bool hidden;
+    };
+
+    struct Import {
+        std::string_view name;
+        std::string_view version;
+        bool weak;
+    };
+
+    struct Object {
+        std::vector<std::string> needed;
+        std::string soname;
+        std::optional<std::string> rpath;
+        std::optional<std::string> runpath;
+        std::unordered_map<std::string_view, std::vector<Export>> exports;
+        std::vector<Import> imports;
+    };
+
+    struct Candidate {
+        std::filesystem::path path;
+        std::string key;
+        elf::Reader reader;
+    };
+}
+
+template<typename F>
+static void parallel(size_t count, size_t concurrency, F &&f) {
+    std::atomic<size_t> next = 0;
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < std::min(std::max<size_t>(concurrency, 1), std::max<size_t>(count, 1)); i++) {
+        threads.emplace_back([&]() {
+            while (true) {
+                size_t index = next++;
+
+                if (index >= count)
+                    break;
+
+                f(index);
+            }
+        });
+    }
+
+    for (auto &thread: threads)
+        thread.join();
+}
+
+static std::string_view string(const std::shared_ptr<elf::ISection> &strings, Elf64_Xword index) {
+    if (!strings || strings->type() == SHT_NOBITS || index >= strings->size())
+        return {};
+
+    auto str = (const char *) strings->data() + index;
+    return {str, strnlen(str, strings->size() - index)};
+}
+
+static std::shared_ptr<elf::ISection> find(const elf::Reader &reader, Elf64_Word type) {
+    for (const auto &section: reader.sections()) {
+        if (section->type() == type)
+            return section;
+    }
+
+    return nullptr;
+}
+
+// version definitions and requirements both map a versym index to a name
+static std::unordered_map<Elf64_Half, std::string_view> versions(const elf::Reader &reader, elf::endian::Type endian) {
+    std::unordered_map<Elf64_Half, std::string_view> names;
+
+    auto definitions = find(reader, SHT_GNU_verdef);
+
+    if (definitions && definitions->type() != SHT_NOBITS) {
+        auto strings = reader.section(definitions->link());
+        elf::Cursor cursor(definitions->data(), definitions->size(), endian);
+
+        Elf64_Off offset = 0;
+
+        for (Elf64_Word i = 0; i < definitions->info(); i++) {
+            cursor.seek(offset);
+
+            cursor.read<Elf64_Half>();
+            auto flags = cursor.read<Elf64_Half>();
+            auto index = cursor.read<Elf64_Half>();
+            cursor.read<Elf64_Half>();
+            cursor.read<Elf64_Word>();
+            auto aux = cursor.read<Elf64_Word>();
+            auto next = cursor.read<Elf64_Word>();
+
+            cursor.seek(offset + aux);
+            auto name = cursor.read<Elf64_Word>();
+
+            if (cursor.failed())
+                break;
+
+            // the base definition names the file itself, its symbols count as unversioned
+            if (!(flags & VER_FLG_BASE))
+                names.emplace(index, string(strings, name));
+
+            if (!next)
+                break;
+
+            offset += next;
+        }
+    }
+
+    auto requirements = find(reader, SHT_GNU_verneed);
+
+    if (requirements && requirements->type() != SHT_NOBITS) {
+        auto strings = reader.section(requirements->link());
+        elf::Cursor cursor(requirements->data(), requirements->size(), endian);
+
+        Elf64_Off offset = 0;
+
+        for (Elf64_Word i = 0; i < requirements->info(); i++) {
+            cursor.seek(offset);
+
+            cursor.read<Elf64_Half>();
+            auto count = cursor.read<Elf64_Half>();
+            cursor.read<Elf64_Word>();
+            auto aux = cursor.read<Elf64_Word>();
+            auto next = cursor.read<Elf64_Word>();
+
+            Elf64_Off position = offset + aux;
+
+            for (Elf64_Half j = 0; j < count && !cursor.failed(); j++) {
+                cursor.seek(position);
+
+                cursor.read<Elf64_Word>();
+                cursor.read<Elf64_Half>();
+                auto index = cursor.read<Elf64_Half>();
+                auto name = cursor.read<Elf64_Word>();
+                auto following = cursor.read<Elf64_Word>();
+
+                if (cursor.failed())
+                    break;
+
+                names.emplace(index, string(strings, name));
+
+                if (!following)
+                    break;
+
+                position += following;
+            }
+
+            if (cursor.failed() || !next)
+                break;
+
+            offset += next;
+        }
+    }
+
+    return names;
+}
+
+static Object parse(const elf::Reader &reader) {
+    Object object;
+
+    auto dynamic = find(reader, SHT_DYNAMIC);
+
+    if (dynamic && dynamic->type() != SHT_NOBITS && dynamic->entrySize()) {
+        elf::DynamicTable table(reader, dynamic);
+
+        for (const auto &entry: table) {
+            Elf64_Sxword tag = entry->tag();
+
+            if (tag == DT_NULL)
+                break;
+
+            if (tag == DT_NEEDED)
+                object.needed.push_back(table.string(entry->value()));
+            else if (tag == DT_SONAME)
+                object.soname = table.string(entry->value());
+            else if (tag == DT_RPATH)
+                object.rpath = table.string(entry->value());
+            else if (tag == DT_RUNPATH)
+                object.runpath = table.string(entry->value());
+        }
+    }
+
+    auto symbols = find(reader, SHT_DYNSYM);
+
+    if (!symbols || symbols->type() == SHT_NOBITS)
+        return object;
+
+    auto endian = reader.header()->ident()[EI_DATA] == ELFDATA2LSB ? elf::endian::Little : elf::endian::Big;
+    auto names = versions(reader, endian);
+    auto versym = find(reader, SHT_GNU_versym);
+
+    elf::SymbolTable table(reader, symbols);
+
+    if (!versym || versym->type() == SHT_NOBITS || versym->size() / sizeof(Elf64_Half) < table.size())
+        versym = nullptr;
+
+    elf::Cursor cursor(versym ? versym->data() : nullptr, versym ? versym->size() : 0, endian);
+
+    for (const auto &symbol: table.views()) {
+        Elf64_Half version = versym ? cursor.read<Elf64_Half>() : 1;
+        unsigned char bind = ELF64_ST_BIND(symbol.info);
+
+        if (symbol.name.empty() || (bind != STB_GLOBAL && bind != STB_WEAK && bind != STB_GNU_UNIQUE))
+            continue;
+
+        auto it = names.find(version & ~VERSYM_HIDDEN);
+        std::string_view name = it != names.end() ? it->second : std::string_view();
+
+        if (symbol.sectionIndex == SHN_UNDEF) {
+            object.imports.push_back({symbol.name, name, bind == STB_WEAK});
+            continue;
+        }
+
+        unsigned char visibility = ELF64_ST_VISIBILITY(symbol.other);
+
+        // index 0 marks symbols the version script made local
+        if (visibility == STV_HIDDEN || visibility == STV_INTERNAL || !(version & ~VERSYM_HIDDEN))
+            continue;
+
+        object.exports[symbol.name].push_back({name, (version & VERSYM_HIDDEN) != 0});
+    }
+
+    return object;
+}
+
+// versioned references need that version, unversioned ones take the default. unversioned definitions satisfy both.
+static bool matches(const std::vector<Export> &exports, std::string_view version) {
+    for (const auto &definition: exports) {
+        if (version.empty() ? !definition.hidden : definition.version.empty() || definition.version == version)
+            return true;
+    }
+
+    return false;
+}
+
+static std::vector<std::filesystem::path> expand(
+        const std::string &list,
+        const std::filesystem::path &origin,
+        bool wide
+) {
+    std::vector<std::filesystem::path> directories;
+
+    for (size_t begin = 0; begin <= list.size();) {
+        size_t end = list.find(':', begin);
+
+        if (end == std::string::npos)
+            end = list.size();
+
+        std::string directory = list.substr(begin, end - begin);
+        begin = end + 1;
+
+        // an empty entry means the working directory, which means nothing for a static image
+        if (directory.empty())
+            continue;
+
+        for (const auto &[token, value]: {
+                std::pair<std::string, std::string>{"$ORIGIN", origin.string()},
+                {"${ORIGIN}", origin.string()},
+                {"$LIB", wide ? "lib64" : "lib"},
+                {"${LIB}", wide ? "lib64" : "lib"}
+        }) {
+            for (size_t position = directory.find(token); position != std::string::npos;
+                 position = directory.find(token, position + value.size()))
+                directory.replace(position, token.size(), value);
+        }
+
+        directories.emplace_back(directory);
+    }
+
+    return directories;
+}
+
+static bool compatible(const elf::Reader &executable, const elf::Reader &library) {
+    auto lhs = executable.header();
+    auto rhs = library.header();
+
+    return lhs->ident()[EI_CLASS] == rhs->ident()[EI_CLASS] &&
+           lhs->ident()[EI_DATA] == rhs->ident()[EI_DATA] &&
+           lhs->machine() == rhs->machine() &&
+           rhs->type() == ET_DYN;
+}
+
+elf::DependencyResolver::DependencyResolver(std::vector<std::filesystem::path> directories, std::filesystem::path root)
+        : mDirectories(std::move(directories)), mRoot(std::move(root)) {
+
+}
+
+tl::expected<elf::DependencyGraph, std::error_code>
+elf::DependencyResolver::resolve(const std::filesystem::path &path, size_t concurrency) const {
+    auto location = host(path);
+
+    if (!location)
+        return tl::unexpected(location.error());
+
+    auto executable = openFile(*location);
+
+    if (!executable)
+        return tl::unexpected(executable.error());
+
+    bool wide = executable->header()->ident()[EI_CLASS] == ELFCLASS64;
+
+    DependencyGraph graph;
+    std::vector<Object> objects;
+
+    graph.objects.push_back({path.filename().string(), path, *executable, std::nullopt, {}, {}});
+    objects.push_back(parse(*executable));
+
+    // the loader matches requested names against both file names and sonames of everything already loaded
+    std::unordered_map<std::string, size_t> loaded;
+    std::unordered_map<std::string, size_t> files;
+
+    std::error_code ec;
+    files.emplace(std::filesystem::weakly_canonical(*location, ec).string(), 0);
+
+    std::vector<size_t> level = {0};
+
+    while (!level.empty()) {
+        std::vector<std::pair<size_t, std::string>> pending;
+
+        for (const auto &index: level) {
+            for (const auto &name: objects[index].needed)
+                pending.emplace_back(index, name);
+        }
+
+        std::vector<std::optional<Candidate>> candidates(pending.size());
+
+        auto probe = [&](size_t i) {
+            const auto &[requester, name] = pending[i];
+            std::vector<std::filesystem::path> directories;
+
+            if (name.find('/') != std::string::npos) {
+                directories.emplace_back();
+            } else {
+                // rpath of the requester and everything that loaded it applies only without a runpath
+                if (!objects[requester].runpath) {
+                    for (std::optional<size_t> object = requester; object; object = graph.objects[*object].loader) {
+                        if (!objects[*object].rpath)
+                            continue;
+
+                        auto origin = graph.objects[*object].path.parent_path();
+                        auto expanded = expand(*objects[*object].rpath, origin, wide);
+
+                        directories.insert(directories.end(), expanded.begin(), expanded.end());
+                    }
+                }
+
+                if (objects[requester].runpath) {
+                    auto origin = graph.objects[requester].path.parent_path();
+                    auto expanded = expand(*objects[requester].runpath, origin, wide);
+
+                    directories.insert(directories.end(), expanded.begin(), expanded.end());
+                }
+
+                directories.insert(directories.end(), mDirectories.begin(), mDirectories.end());
+            }
+
+            for (const auto &directory: directories) {
+                auto candidate = directory.empty() ? std::filesystem::path(name) : directory / name;
+                auto file = host(candidate);
+
+                std::error_code error;
+
+                if (!file || !std::filesystem::is_regular_file(*file, error))
+                    continue;
+
+                auto reader = openFile(*file);
+
+                // a library for another architecture is skipped like the loader does
+                if (!reader || !compatible(*executable, *reader))
+                    continue;
+
+                auto key = std::filesystem::weakly_canonical(*file, error).string();
+                candidates[i] = Candidate{candidate.lexically_normal(), std::move(key), std::move(*reader)};
+
+                break;
+            }
+        };
+
+        // a name requested several times on one level is loaded by its first requester, the rest reuse it
+        std::vector<size_t> unique;
+        std::unordered_map<std::string_view, size_t> first;
+
+        for (size_t i = 0; i < pending.size(); i++) {
+            if (loaded.find(pending[i].second) == loaded.end() && first.emplace(pending[i].second, i).second)
+                unique.push_back(i);
+        }
+
+        parallel(unique.size(), concurrency, [&](size_t i) {
+            probe(unique[i]);
+        });
+
+        std::vector<size_t> next;
+
+        for (size_t i = 0; i < pending.size(); i++) {
+            const auto &[requester, name] = pending[i];
+            auto it = loaded.find(name);
+
+            if (it != loaded.end()) {
+                graph.objects[requester].needed.push_back(it->second);
+                continue;
+            }
+
+            // the first requester missed it, a later one may still find it through its own rpath
+            if (first.at(name) != i)
+                probe(i);
+
+            if (!candidates[i]) {
+                graph.objects[requester].missing.push_back(name);
+                continue;
+            }
+
+            auto [file, inserted] = files.try_emplace(candidates[i]->key, graph.objects.size());
+
+            if (inserted) {
+                graph.objects.push_back({name, candidates[i]->path, candidates[i]->reader, requester, {}, {}});
+                next.push_back(file->second);
+            }
+
+            loaded.emplace(name, file->second);
+            graph.objects[requester].needed.push_back(file->second);
+        }
+
+        objects.resize(graph.objects.size());
+
+        parallel(next.size(), concurrency, [&](size_t i) {
+            objects[next[i]] = parse(graph.objects[next[i]].reader);
+        });
+
+        for (const auto &index: next) {
+            if (objects[index].soname.empty())
+                continue;
+
+            graph.objects[index].name = objects[index].soname;
+            loaded.emplace(objects[index].soname, index);
+        }
+
+        level = std::move(next);
+    }
+
+    // every object sees the global scope in load order, the first matching definition wins regardless of weakness
+    std::vector<std::vector<SymbolBinding>> bindings(graph.objects.size());
+
+    parallel(graph.objects.size(), concurrency, [&](size_t index) {
+        for (const auto &import: objects[index].imports) {
+            std::optional<size_t> provider;
+
+            for (size_t i = 0; i < objects.size(); i++) {
+                auto it = objects[i].exports.find(import.name);
+
+                if (it != objects[i].exports.end() && matches(it->second, import.version)) {
+                    provider = i;
+                    break;
+                }
+            }
+
+            bindings[index].push_back({
+                    index,
+                    std::string(import.name),
+                    std::string(import.version),
+                    import.weak,
+                    provider
+            });
+        }
+    });
+
+    for (auto &object: bindings) {
+        graph.bindings.insert(
+                graph.bindings.end(),
+                std::make_move_iterator(object.begin()),
+                std::make_move_iterator(object.end())
+        );
+    }
+
+    return graph;
+}
+
+tl::expected<std::filesystem::path, std::error_code> elf::DependencyResolver::host(const std::filesystem::path &path) const {
+    if (mRoot.empty() || mRoot == "/" || path.is_relative())
+        return path;
+
+    // an absolute link such as /lib64/ld-linux-x86-64.so.2 points into root, not into the host
+    auto relative = path.relative_path();
+    std::vector<std::filesystem::path> components(relative.begin(), relative.end());
+    std::reverse(components.begin(), components.end());
+
+    std::filesystem::path resolved;
+    size_t links = 0;
+
+    while (!components.empty()) {
+        auto component = std::move(components.back());
+        components.pop_back();
+
+        if (component.empty() || component == ".")
+            continue;
+
+        // .. stops at root
+        if (component == "..") {
+            resolved = resolved.parent_path();
+            continue;
+        }
+
+        std::error_code ec;
+        auto next = resolved / component;
+        auto status = std::filesystem::symlink_status(mRoot / next, ec);
+
+        if (!std::filesystem::exists(status))
+            return tl::unexpected(make_error_code(std::errc::no_such_file_or_directory));
+
+        if (ec)
+            return tl::unexpected(ec);
+
+        if (!std::filesystem::is_symlink(status)) {
+            resolved = std::move(next);
+            continue;
+        }
+
+        if (++links > MAX_SYMLINKS)
+            return tl::unexpected(make_error_code(std::errc::too_many_symbolic_link_levels));
+
+        auto target = std::filesystem::read_symlink(mRoot / next, ec);
+
+        if (ec)
+            return tl::unexpected(ec);
+
+        if (target.is_absolute())
+            resolved.clear();
+
+        relative = target.relative_path();
+        std::vector<std::filesystem::path> parts(relative.begin(), relative.end());
+
+        components.insert(components.end(), parts.rbegin(), parts.rend());
+    }
+
+    return mRoot / resolved;
+}
@@ -0,0 +1,295 @@
+#include <elf/diff.h>
+#include <elf/symbol.h>
+#include <atomic>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+
+constexpr auto PARALLEL_CHUNK = 64;
+constexpr auto HASH_BLOCK = 1 << 16;
+
+namespace {
+    struct Entry {
+        std::string_view name;
+        unsigned char type;
+        Elf64_Xword size;
+        const std::byte *data;
+    };
+
+    struct Key {
+        std::string_view name;
+        unsigned char type;
+
+        bool operator==(const Key &rhs) const {
+            return type == rhs.type && name == rhs.name;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const {
+            return std::hash<std::string_view>()(key.name) ^ (key.type * 0x9e3779b97f4a7c15);
+        }
+    };
+
+    struct Block {
+        size_t pair;
+        Elf64_Xword offset;
+        Elf64_Xword size;
+    };
+
+    struct Match {
+        const Entry *before;
+        const Entry *after;
+        bool content;
+    };
+}
+
+static Elf64_Xword rotate(Elf64_Xword value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// word-at-a-time multiplicative hash, strong enough to flag changed bytes
+static Elf64_Xword hash(const std::byte *data, Elf64_Xword size) {
+    constexpr Elf64_Xword PRIME1 = 0x9e3779b97f4a7c15;
+    constexpr Elf64_Xword PRIME2 = 0xbf58476d1ce4e5b9;
+
+    Elf64_Xword h = size * PRIME1;
+    Elf64_Xword i = 0;
+
+    for (; size - i >= 8; i += 8) {
+        Elf64_Xword word;
+        memcpy(&word, data + i, sizeof(word));
+        h = rotate(h ^ (word * PRIME1), 31) * PRIME2;
+    }
+
+    Elf64_Xword tail = 0;
+    memcpy(&tail, data + i, size - i);
+    h = rotate(h ^ (tail * PRIME1), 31) * PRIME2;
+
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccd;
+    h ^= h >> 33;
+
+    return h;
+}
+
+template<typename F>
+static void parallel(size_t count, size_t concurrency, F &&f) {
+    std::atomic<size_t> next = 0;
+    std::vector<std::thread> threads;
+
+    size_t chunks = (count + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+
+    for (size_t i = 0; i < std::min(std::max<size_t>(concurrency, 1), std::max<size_t>(chunks, 1)); i++) {
+        threads.emplace_back([&]() {
+            while (true) {
+                size_t begin = next.fetch_add(PARALLEL_CHUNK);
+
+                if (begin >= count)
+                    break;
+
+                for (size_t index = begin; index < std::min(count, begin + PARALLEL_CHUNK); index++)
+                    f(index);
+            }
+        });
+    }
+
+    for (auto &thread: threads)
+        thread.join();
+}
+
+static std::vector<Entry> sections(const elf::Reader &reader) {
+    auto strings = reader.section(reader.header()->sectionStrIndex());
+
+    if (!strings || strings->type() == SHT_NOBITS)
+        return {};
+
+    auto table = (const char *) strings->data();
+    std::vector<Entry> entries;
+
+    for (const auto &section: reader.sections()) {
+        if (section->type() == SHT_NULL || section->nameIndex() >= strings->size())
+            continue;
+
+        entries.push_back({
+                {table + section->nameIndex(), strnlen(table + section->nameIndex(), strings->size() - section->nameIndex())},
+                0,
+                section->size(),
+                section->type() == SHT_NOBITS ? nullptr : section->data()
+        });
+    }
+
+    return entries;
+}
+
+static std::vector<Entry> symbols(const elf::Reader &reader) {
+    auto table = reader.section(".symtab");
+
+    if (!table || table->type() != SHT_SYMTAB)
+        table = reader.section(".dynsym");
+
+    if (!table || table->type() == SHT_NOBITS)
+        return {};
+
+    bool relocatable = reader.header()->type() == ET_REL;
+    std::vector<Entry> entries;
+
+    for (const auto &symbol: elf::SymbolTable(reader, table).views()) {
+        unsigned char type = ELF64_ST_TYPE(symbol.info);
+
+        if (symbol.name.empty() || type == STT_SECTION || type == STT_FILE)
+            continue;
+
+        Entry entry = {symbol.name, type, symbol.size, nullptr};
+
+        // bytes are only comparable for symbols inside a section with file contents
+        auto section = symbol.sectionIndex == SHN_UNDEF || type == STT_TLS ? nullptr : reader.section(symbol.sectionIndex);
+
+        if (section && section->type() != SHT_NOBITS) {
+            Elf64_Addr offset = relocatable ? symbol.value : symbol.value - section->address();
+
+            if (offset <= section->size() && symbol.size <= section->size() - offset)
+                entry.data = section->data() + offset;
+        }
+
+        entries.push_back(entry);
+    }
+
+    return entries;
+}
+
+// hash join on (name, type), pairing repeated keys in order, then hashing same-sized pairs in parallel.
+// large bodies are split into blocks so one big section does not leave the other threads idle.
+static std::vector<Match> join(const std::vector<Entry> &before, const std::vector<Entry> &after, size_t concurrency) {
+    std::unordered_map<Key, size_t, KeyHash> heads;
+    std::vector<size_t> next(before.size());
+    std::vector<bool> used(before.size());
+
+    heads.reserve(before.size());
+
+    for (size_t i = before.size(); i > 0; i--) {
+        auto [it, inserted] = heads.try_emplace({before[i - 1].name, before[i - 1].type}, i - 1);
+
+        next[i - 1] = inserted ? before.size() : it->second;
+        it->second = i - 1;
+    }
+
+    std::vector<Match> matches;
+    std::vector<std::pair<size_t, size_t>> pairs;
+
+    for (size_t i = 0; i < after.size(); i++) {
+        auto it = heads.find({after[i].name, after[i].type});
+
+        if (it == heads.end() || it->second == before.size()) {
+            matches.push_back({nullptr, &after[i], false});
+            continue;
+        }
+
+        size_t match = it->second;
+
+        it->second = next[match];
+        used[match] = true;
+
+        if (before[match].size != after[i].size)
+            matches.push_back({&before[match], &after[i], false});
+        else if (before[match].data && after[i].data && before[match].size)
+            pairs.emplace_back(match, i);
+    }
+
+    for (size_t i = 0; i < before.size(); i++) {
+        if (!used[i])
+            matches.push_back({&before[i], nullptr, false});
+    }
+
+    std::vector<Block> blocks;
+
+    for (size_t i = 0; i < pairs.size(); i++) {
+        Elf64_Xword size = before[pairs[i].first].size;
+
+        for (Elf64_Xword offset = 0; offset < size; offset += HASH_BLOCK)
+            blocks.push_back({i, offset, std::min<Elf64_Xword>(HASH_BLOCK, size - offset)});
+    }
+
+    std::vector<char> differs(blocks.size());
+
+    parallel(blocks.size(), concurrency, [&](size_t index) {
+        const auto &block = blocks[index];
+        const auto &lhs = before[pairs[block.pair].first];
+        const auto &rhs = after[pairs[block.pair].second];
+
+        differs[index] = hash(lhs.data + block.offset, block.size) != hash(rhs.data + block.offset, block.size);
+    });
+
+    std::vector<char> changed(pairs.size());
+
+    for (size_t i = 0; i < blocks.size(); i++) {
+        if (differs[i])
+            changed[blocks[i].pair] = true;
+    }
+
+    for (size_t i = 0; i < pairs.size(); i++) {
+        if (changed[i])
+            matches.push_back({&before[pairs[i].first], &after[pairs[i].second], true});
+    }
+
+    std::sort(
+            matches.begin(),
+            matches.end(),
+            [](const auto &lhs, const auto &rhs) {
+                const Entry *l = lhs.before ? lhs.before : lhs.after;
+                const Entry *r = rhs.before ? rhs.before : rhs.after;
+
+                if (l->name != r->name)
+                    return l->name < r->name;
+
+                return l->type < r->type;
+            }
+    );
+
+    return matches;
+}
+
+static elf::ChangeType type(const Match &match) {
+    if (!match.before)
+        return elf::ChangeType::ADDED;
+
+    if (!match.after)
+        return elf::ChangeType::REMOVED;
+
+    return elf::ChangeType::MODIFIED;
+}
+
+elf::Diff elf::diff(const Reader &before, const Reader &after, size_t concurrency) {
+    Diff result;
+
+    auto lhs = ::sections(before);
+    auto rhs = ::sections(after);
+
+    for (const auto &match: join(lhs, rhs, concurrency)) {
+        result.sections.push_back({
+                std::string(match.before ? match.before->name : match.after->name),
+                type(match),
+                match.before ? match.before->size : 0,
+                match.after ? match.after->size : 0,
+                match.content
+        });
+    }
+
+    lhs = ::symbols(before);
+    rhs = ::symbols(after);
+
+    for (const auto &match: join(lhs, rhs, concurrency)) {
+        const Entry *entry = match.before ? match.before : match.after;
+
+        result.symbols.push_back({
+                std::string(entry->name),
+                entry->type,
+                type(match),
+                match.before ? match.before->size : 0,
+                match.after ? match.after->size : 0,
+                match.content
+        });
+    }
+
+    return result;
+}
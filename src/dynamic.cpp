@@ -0,0 +1,105 @@
+#include <elf/dynamic.h>
+#include <cstring>
+
+template<typename T, elf::endian::Type Endian>
+elf::Dynamic<T, Endian>::Dynamic(const T *dynamic) : mDynamic() {
+    std::memcpy(&mDynamic, dynamic, sizeof(T));
+}
+
+template<typename T, elf::endian::Type Endian>
+Elf64_Sxword elf::Dynamic<T, Endian>::tag() {
+    return endian::convert<Endian>(mDynamic.d_tag);
+}
+
+template<typename T, elf::endian::Type Endian>
+Elf64_Xword elf::Dynamic<T, Endian>::value() {
+    return endian::convert<Endian>(mDynamic.d_un.d_val);
+}
+
+elf::DynamicIterator::DynamicIterator(const std::byte *dynamic, size_t size, endian::Type endian)
+        : mSize(size), mEndian(endian), mDynamic(dynamic) {
+
+}
+
+std::unique_ptr<elf::IDynamic> elf::DynamicIterator::operator*() {
+    if (mSize == sizeof(Elf64_Dyn)) {
+        if (mEndian == endian::Little)
+            return std::make_unique<Dynamic<Elf64_Dyn, endian::Little>>((const Elf64_Dyn *) mDynamic);
+        else
+            return std::make_unique<Dynamic<Elf64_Dyn, endian::Big>>((const Elf64_Dyn *) mDynamic);
+    } else {
+        if (mEndian == endian::Little)
+            return std::make_unique<Dynamic<Elf32_Dyn, endian::Little>>((const Elf32_Dyn *) mDynamic);
+        else
+            return std::make_unique<Dynamic<Elf32_Dyn, endian::Big>>((const Elf32_Dyn *) mDynamic);
+    }
+}
+
+elf::DynamicIterator &elf::DynamicIterator::operator++() {
+    mDynamic += mSize;
+    return *this;
+}
+
+elf::DynamicIterator elf::DynamicIterator::operator+(size_t offset) {
+    DynamicIterator it = *this;
+    it.mDynamic += offset * mSize;
+    return it;
+}
+
+bool elf::DynamicIterator::operator==(const elf::DynamicIterator &rhs) {
+    return mDynamic == rhs.mDynamic;
+}
+
+bool elf::DynamicIterator::operator!=(const elf::DynamicIterator &rhs) {
+    return !operator==(rhs);
+}
+
+elf::DynamicTable::DynamicTable(elf::Reader reader, std::shared_ptr<ISection> section)
+        : mReader(std::move(reader)), mSection(std::move(section)) {
+
+}
+
+size_t elf::DynamicTable::size() {
+    if (!mSection->entrySize())
+        return 0;
+
+    return mSection->size() / mSection->entrySize();
+}
+
+std::string elf::DynamicTable::string(Elf64_Xword index) {
+    auto section = mReader.section(mSection->link());
+
+    if (!section || index >= section->size())
+        return {};
+
+    auto str = (const char *) section->data() + index;
+    return {str, strnlen(str, section->size() - index)};
+}
+
+std::unique_ptr<elf::IDynamic> elf::DynamicTable::operator[](size_t index) {
+    return *(begin() + index);
+}
+
+elf::DynamicIterator elf::DynamicTable::begin() {
+    return {
+            mSection->data(),
+            mSection->entrySize(),
+            mReader.header()->ident()[EI_DATA] == ELFDATA2LSB ? endian::Little : endian::Big
+    };
+}
+
+elf::DynamicIterator elf::DynamicTable::end() {
+    return begin() + size();
+}
+
+template
+class elf::Dynamic<Elf32_Dyn, elf::endian::Little>;
+
+template
+class elf::Dynamic<Elf32_Dyn, elf::endian::Big>;
+
+template
+class elf::Dynamic<Elf64_Dyn, elf::endian::Little>;
+
+template
+class elf::Dynamic<Elf64_Dyn, elf::endian::Big>;
@@ -24,6 +24,30 @@ std::string elf::Category::message(int value) const {
             msg = "invalid elf endian";
             break;
 
+        case INVALID_COMPRESSION_HEADER:
+            msg = "invalid compression header";
+            break;
+
+        case UNSUPPORTED_COMPRESSION:
+            msg = "unsupported compression";
+            break;
+
+        case DECOMPRESSION_FAILED:
+            msg = "decompression failed";
+            break;
+
+        case INVALID_ARCHIVE_MAGIC:
+            msg = "invalid archive magic";
+            break;
+
+        case INVALID_ARCHIVE_HEADER:
+            msg = "invalid archive header";
+            break;
+
+        case SECTION_OVERFLOW:
+            msg = "section contents exceed allocated size";
+            break;
+
         default:
             msg = "unknown";
             break;
@@ -1,78 +1,103 @@
 #include <elf/header.h>
+#include <cstring>
 
 template<typename T, elf::endian::Type Endian>
-elf::Header<T, Endian>::Header(const T *header) : mHeader(header) {
-
+elf::Header<T, Endian>::Header(const T *header) : mHeader(), mBuffer((const std::byte *) header) {
+    // archive members and embedded images need not be aligned
+    std::memcpy(&mHeader, header, sizeof(T));
 }
 
 template<typename T, elf::endian::Type Endian>
 const unsigned char *elf::Header<T, Endian>::ident() {
-    return mHeader->e_ident;
+    return mHeader.e_ident;
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Half elf::Header<T, Endian>::type() {
-    return endian::convert<Endian>(mHeader->e_type);
+    return endian::convert<Endian>(mHeader.e_type);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Half elf::Header<T, Endian>::machine() {
-    return endian::convert<Endian>(mHeader->e_machine);
+    return endian::convert<Endian>(mHeader.e_machine);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Word elf::Header<T, Endian>::version() {
-    return endian::convert<Endian>(mHeader->e_version);
+    return endian::convert<Endian>(mHeader.e_version);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Addr elf::Header<T, Endian>::entry() {
-    return endian::convert<Endian>(mHeader->e_entry);
+    return endian::convert<Endian>(mHeader.e_entry);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Off elf::Header<T, Endian>::segmentOffset() {
-    return endian::convert<Endian>(mHeader->e_phoff);
+    return endian::convert<Endian>(mHeader.e_phoff);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Off elf::Header<T, Endian>::sectionOffset() {
-    return endian::convert<Endian>(mHeader->e_shoff);
+    return endian::convert<Endian>(mHeader.e_shoff);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Word elf::Header<T, Endian>::flags() {
-    return endian::convert<Endian>(mHeader->e_flags);
+    return endian::convert<Endian>(mHeader.e_flags);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Half elf::Header<T, Endian>::headerSize() {
-    return endian::convert<Endian>(mHeader->e_ehsize);
+    return endian::convert<Endian>(mHeader.e_ehsize);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Half elf::Header<T, Endian>::segmentEntrySize() {
-    return endian::convert<Endian>(mHeader->e_phentsize);
+    return endian::convert<Endian>(mHeader.e_phentsize);
 }
 
 template<typename T, elf::endian::Type Endian>
-Elf64_Half elf::Header<T, Endian>::segmentNum() {
-    return endian::convert<Endian>(mHeader->e_phnum);
+Elf64_Word elf::Header<T, Endian>::segmentNum() {
+    Elf64_Half num = endian::convert<Endian>(mHeader.e_phnum);
+
+    if (num != PN_XNUM || !sectionOffset())
+        return num;
+
+    return endian::convert<Endian>(initial().sh_info);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Half elf::Header<T, Endian>::sectionEntrySize() {
-    return endian::convert<Endian>(mHeader->e_shentsize);
+    return endian::convert<Endian>(mHeader.e_shentsize);
 }
 
 template<typename T, elf::endian::Type Endian>
-Elf64_Half elf::Header<T, Endian>::sectionNum() {
-    return endian::convert<Endian>(mHeader->e_shnum);
+Elf64_Word elf::Header<T, Endian>::sectionNum() {
+    Elf64_Half num = endian::convert<Endian>(mHeader.e_shnum);
+
+    if (num || !sectionOffset())
+        return num;
+
+    return endian::convert<Endian>(initial().sh_size);
 }
 
 template<typename T, elf::endian::Type Endian>
-Elf64_Half elf::Header<T, Endian>::sectionStrIndex() {
-    return endian::convert<Endian>(mHeader->e_shstrndx);
+Elf64_Word elf::Header<T, Endian>::sectionStrIndex() {
+    Elf64_Half index = endian::convert<Endian>(mHeader.e_shstrndx);
+
+    if (index != SHN_XINDEX || !sectionOffset())
+        return index;
+
+    return endian::convert<Endian>(initial().sh_link);
+}
+
+template<typename T, elf::endian::Type Endian>
+typename elf::Header<T, Endian>::Shdr elf::Header<T, Endian>::initial() {
+    Shdr section;
+    std::memcpy(&section, mBuffer + sectionOffset(), sizeof(Shdr));
+
+    return section;
 }
 
 template
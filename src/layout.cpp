@@ -0,0 +1,172 @@
+#include <elf/layout.h>
+#include <algorithm>
+
+static const std::vector<size_t> EMPTY;
+
+static bool tbss(elf::ISection &section) {
+    return (section.flags() & SHF_TLS) && section.type() == SHT_NOBITS;
+}
+
+// same rules as binutils: tls sections only in tls, relro or load segments, .tbss only in tls segments,
+// sections outside the image only in segments that describe file contents
+static bool contains(elf::ISegment &segment, elf::ISection &section) {
+    bool tls = section.flags() & SHF_TLS;
+    Elf64_Word type = segment.type();
+
+    if (tls && type != PT_TLS && type != PT_GNU_RELRO && type != PT_LOAD)
+        return false;
+
+    if (!tls && type == PT_TLS)
+        return false;
+
+    if (tbss(section) && type != PT_TLS)
+        return false;
+
+    if (!(section.flags() & SHF_ALLOC) &&
+        (type == PT_LOAD || type == PT_DYNAMIC || type == PT_GNU_EH_FRAME || type == PT_GNU_STACK || type == PT_GNU_RELRO))
+        return false;
+
+    // empty sections on the end boundary belong to the next segment
+    auto inside = [&](Elf64_Off begin, Elf64_Off base, Elf64_Xword length) {
+        if (begin < base || begin - base > length)
+            return false;
+
+        if (!section.size())
+            return begin - base < length || !length;
+
+        return section.size() <= length - (begin - base);
+    };
+
+    if (section.type() != SHT_NOBITS && !inside(section.offset(), segment.offset(), segment.fileSize()))
+        return false;
+
+    if (section.flags() & SHF_ALLOC)
+        return inside(section.address(), segment.virtualAddress(), segment.memorySize());
+
+    return section.type() != SHT_NOBITS;
+}
+
+elf::Layout::Layout(const Reader &reader) {
+    const auto &segments = reader.segments();
+    const auto &sections = reader.sections();
+
+    mSegments.resize(sections.size());
+    mSections.resize(segments.size());
+    mLoads.resize(segments.size());
+
+    for (size_t i = 0; i < segments.size(); i++) {
+        auto &segment = *segments[i];
+
+        for (size_t j = 1; j < sections.size(); j++) {
+            if (!contains(segment, *sections[j]))
+                continue;
+
+            mSegments[j].push_back(i);
+            mSections[i].push_back(j);
+        }
+
+        if (segment.type() != PT_LOAD)
+            continue;
+
+        mLoads[i] = {segment.virtualAddress(), segment.offset(), segment.fileSize()};
+
+        if (segment.memorySize())
+            mLoadAddresses.push_back({segment.virtualAddress(), segment.virtualAddress() + segment.memorySize(), i});
+
+        if (segment.fileSize())
+            mLoadOffsets.push_back({segment.offset(), segment.offset() + segment.fileSize(), i});
+    }
+
+    for (size_t i = 1; i < sections.size(); i++) {
+        auto &section = *sections[i];
+
+        if (!section.size())
+            continue;
+
+        if ((section.flags() & SHF_ALLOC) && !tbss(section))
+            mSectionAddresses.push_back({section.address(), section.address() + section.size(), i});
+
+        if (section.type() != SHT_NOBITS)
+            mSectionOffsets.push_back({section.offset(), section.offset() + section.size(), i});
+    }
+
+    for (auto *intervals: {&mLoadAddresses, &mLoadOffsets, &mSectionAddresses, &mSectionOffsets}) {
+        std::sort(
+                intervals->begin(),
+                intervals->end(),
+                [](const auto &lhs, const auto &rhs) {
+                    return lhs.begin < rhs.begin;
+                }
+        );
+    }
+}
+
+const std::vector<size_t> &elf::Layout::segments(size_t section) const {
+    if (section >= mSegments.size())
+        return EMPTY;
+
+    return mSegments[section];
+}
+
+const std::vector<size_t> &elf::Layout::sections(size_t segment) const {
+    if (segment >= mSections.size())
+        return EMPTY;
+
+    return mSections[segment];
+}
+
+std::optional<Elf64_Addr> elf::Layout::address(Elf64_Off offset) const {
+    auto index = find(mLoadOffsets, offset);
+
+    if (!index)
+        return std::nullopt;
+
+    return mLoads[*index].address + (offset - mLoads[*index].offset);
+}
+
+std::optional<Elf64_Off> elf::Layout::offset(Elf64_Addr address) const {
+    auto index = find(mLoadAddresses, address);
+
+    // zero filled memory past the file image has no offset
+    if (!index || address - mLoads[*index].address >= mLoads[*index].fileSize)
+        return std::nullopt;
+
+    return mLoads[*index].offset + (address - mLoads[*index].address);
+}
+
+std::optional<size_t> elf::Layout::segmentByAddress(Elf64_Addr address) const {
+    return find(mLoadAddresses, address);
+}
+
+std::optional<size_t> elf::Layout::segmentByOffset(Elf64_Off offset) const {
+    return find(mLoadOffsets, offset);
+}
+
+std::optional<size_t> elf::Layout::sectionByAddress(Elf64_Addr address) const {
+    return find(mSectionAddresses, address);
+}
+
+std::optional<size_t> elf::Layout::sectionByOffset(Elf64_Off offset) const {
+    return find(mSectionOffsets, offset);
+}
+
+std::optional<size_t> elf::Layout::find(const std::vector<Interval> &intervals, Elf64_Off value) {
+    auto it = std::upper_bound(
+            intervals.begin(),
+            intervals.end(),
+            value,
+            [](Elf64_Off value, const auto &interval) {
+                return value < interval.begin;
+            }
+    );
+
+    if (it == intervals.begin())
+        return std::nullopt;
+
+    it--;
+
+    if (value >= it->end)
+        return std::nullopt;
+
+    return it->index;
+}
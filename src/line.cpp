@@ -0,0 +1,835 @@
+#include <elf/line.h>
+#include "cursor.h"
+#include "dwarf.h"
+#include <map>
+#include <algorithm>
+
+namespace elf {
+    namespace {
+        struct Value {
+            Elf64_Xword number;
+            std::string_view string;
+        };
+
+        // reads one attribute value, block-like forms are skipped and yield zero
+        bool attribute(
+                Cursor &cursor,
+                Elf64_Xword form,
+                Elf64_Sxword implicit,
+                size_t addressSize,
+                size_t offsetSize,
+                Value &value
+        ) {
+            value = {};
+
+            switch (form) {
+                case DW_FORM_addr:
+                    value.number = addressSize == 8 ? cursor.read<Elf64_Xword>() : cursor.read<Elf32_Word>();
+                    break;
+
+                case DW_FORM_data1:
+                case DW_FORM_ref1:
+                case DW_FORM_flag:
+                case DW_FORM_strx1:
+                case DW_FORM_addrx1:
+                    value.number = cursor.read<uint8_t>();
+                    break;
+
+                case DW_FORM_data2:
+                case DW_FORM_ref2:
+                case DW_FORM_strx2:
+                case DW_FORM_addrx2:
+                    value.number = cursor.read<uint16_t>();
+                    break;
+
+                case DW_FORM_strx3:
+                case DW_FORM_addrx3:
+                    cursor.skip(3);
+                    break;
+
+                case DW_FORM_data4:
+                case DW_FORM_ref4:
+                case DW_FORM_ref_sup4:
+                case DW_FORM_strx4:
+                case DW_FORM_addrx4:
+                    value.number = cursor.read<uint32_t>();
+                    break;
+
+                case DW_FORM_data8:
+                case DW_FORM_ref8:
+                case DW_FORM_ref_sig8:
+                case DW_FORM_ref_sup8:
+                    value.number = cursor.read<uint64_t>();
+                    break;
+
+                case DW_FORM_data16:
+                    cursor.skip(16);
+                    break;
+
+                case DW_FORM_sdata:
+                    value.number = cursor.signedLEB128();
+                    break;
+
+                case DW_FORM_udata:
+                case DW_FORM_ref_udata:
+                case DW_FORM_strx:
+                case DW_FORM_addrx:
+                case DW_FORM_loclistx:
+                case DW_FORM_rnglistx:
+                case DW_FORM_GNU_addr_index:
+                case DW_FORM_GNU_str_index:
+                    value.number = cursor.unsignedLEB128();
+                    break;
+
+                case DW_FORM_strp:
+                case DW_FORM_line_strp:
+                case DW_FORM_sec_offset:
+                case DW_FORM_ref_addr:
+                case DW_FORM_strp_sup:
+                case DW_FORM_GNU_ref_alt:
+                case DW_FORM_GNU_strp_alt:
+                    value.number = offsetSize == 8 ? cursor.read<uint64_t>() : cursor.read<uint32_t>();
+                    break;
+
+                case DW_FORM_string:
+                    value.string = cursor.string();
+                    break;
+
+                case DW_FORM_block1:
+                    cursor.skip(cursor.read<uint8_t>());
+                    break;
+
+                case DW_FORM_block2:
+                    cursor.skip(cursor.read<uint16_t>());
+                    break;
+
+                case DW_FORM_block4:
+                    cursor.skip(cursor.read<uint32_t>());
+                    break;
+
+                case DW_FORM_block:
+                case DW_FORM_exprloc:
+                    cursor.skip(cursor.unsignedLEB128());
+                    break;
+
+                case DW_FORM_flag_present:
+                    value.number = 1;
+                    break;
+
+                case DW_FORM_implicit_const:
+                    value.number = implicit;
+                    break;
+
+                case DW_FORM_indirect:
+                    return attribute(cursor, cursor.unsignedLEB128(), implicit, addressSize, offsetSize, value);
+
+                default:
+                    return false;
+            }
+
+            return !cursor.failed();
+        }
+
+        std::string_view string(const std::pair<const std::byte *, Elf64_Xword> &section, Elf64_Xword offset) {
+            if (!section.first || offset >= section.second)
+                return {};
+
+            auto str = (const char *) section.first + offset;
+            return {str, strnlen(str, section.second - offset)};
+        }
+
+        std::string join(std::string_view directory, std::string_view name) {
+            if (directory.empty() || (!name.empty() && name[0] == '/'))
+                return std::string(name);
+
+            std::string path(directory);
+
+            if (path.back() != '/')
+                path += '/';
+
+            return path.append(name);
+        }
+    }
+}
+
+elf::LineTable::LineTable(elf::Reader reader) : mReader(std::move(reader)) {
+    auto header = mReader.header();
+
+    mEndian = header->ident()[EI_DATA] == ELFDATA2LSB ? endian::Little : endian::Big;
+    mAddressSize = header->ident()[EI_CLASS] == ELFCLASS64 ? 8 : 4;
+}
+
+std::pair<const std::byte *, Elf64_Xword> elf::LineTable::section(std::string_view name) const {
+    auto it = mBuffers.find(name);
+
+    if (it == mBuffers.end())
+        return {nullptr, 0};
+
+    return {it->second.data, it->second.size};
+}
+
+std::optional<elf::LineTable::Unit>
+elf::LineTable::unit(Elf64_Off offset, Elf64_Addr *low, Elf64_Addr *high) const {
+    auto info = section(".debug_info");
+    auto abbreviation = section(".debug_abbrev");
+
+    if (!info.first || !abbreviation.first)
+        return std::nullopt;
+
+    Cursor cursor(info.first, info.second, mEndian);
+    cursor.seek(offset);
+
+    size_t offsetSize = 4;
+    Elf64_Xword length = cursor.read<uint32_t>();
+
+    if (length == 0xffffffff) {
+        offsetSize = 8;
+        length = cursor.read<uint64_t>();
+    }
+
+    if (length > cursor.remaining())
+        return std::nullopt;
+
+    Cursor body(cursor.current(), length, mEndian);
+
+    auto version = body.read<uint16_t>();
+    size_t addressSize;
+    Elf64_Off abbreviationOffset;
+
+    if (version < 2 || version > 5)
+        return std::nullopt;
+
+    if (version == 5) {
+        auto type = body.read<uint8_t>();
+        addressSize = body.read<uint8_t>();
+        abbreviationOffset = offsetSize == 8 ? body.read<uint64_t>() : body.read<uint32_t>();
+
+        if (type == DW_UT_skeleton || type == DW_UT_split_compile)
+            body.skip(8);
+        else if (type == DW_UT_type || type == DW_UT_split_type)
+            return std::nullopt;
+    } else {
+        abbreviationOffset = offsetSize == 8 ? body.read<uint64_t>() : body.read<uint32_t>();
+        addressSize = body.read<uint8_t>();
+    }
+
+    auto code = body.unsignedLEB128();
+
+    if (!code || body.failed())
+        return std::nullopt;
+
+    Cursor abbreviations(abbreviation.first, abbreviation.second, mEndian);
+    abbreviations.seek(abbreviationOffset);
+
+    std::vector<std::tuple<Elf64_Xword, Elf64_Xword, Elf64_Sxword>> specifications;
+
+    while (true) {
+        auto current = abbreviations.unsignedLEB128();
+
+        if (!current || abbreviations.failed())
+            return std::nullopt;
+
+        abbreviations.unsignedLEB128();
+        abbreviations.read<uint8_t>();
+
+        specifications.clear();
+
+        while (!abbreviations.failed()) {
+            auto name = abbreviations.unsignedLEB128();
+            auto form = abbreviations.unsignedLEB128();
+
+            if (!name && !form)
+                break;
+
+            specifications.emplace_back(
+                    name,
+                    form,
+                    form == DW_FORM_implicit_const ? abbreviations.signedLEB128() : 0
+            );
+        }
+
+        if (current == code)
+            break;
+    }
+
+    std::optional<Elf64_Off> statement;
+    std::optional<Elf64_Addr> lowPC;
+    std::optional<Elf64_Addr> highPC;
+    bool relative = false;
+
+    Unit result = {};
+
+    for (const auto &[name, form, implicit]: specifications) {
+        Value value;
+
+        if (!attribute(body, form, implicit, addressSize, offsetSize, value))
+            return std::nullopt;
+
+        switch (name) {
+            case DW_AT_stmt_list:
+                statement = value.number;
+                break;
+
+            case DW_AT_comp_dir:
+                if (form == DW_FORM_string)
+                    result.directory = value.string;
+                else if (form == DW_FORM_strp)
+                    result.directory = string(section(".debug_str"), value.number);
+                else if (form == DW_FORM_line_strp)
+                    result.directory = string(section(".debug_line_str"), value.number);
+
+                break;
+
+            case DW_AT_low_pc:
+                if (form == DW_FORM_addr)
+                    lowPC = value.number;
+
+                break;
+
+            case DW_AT_high_pc:
+                if (form == DW_FORM_addr || form == DW_FORM_data1 || form == DW_FORM_data2 ||
+                    form == DW_FORM_data4 || form == DW_FORM_data8 || form == DW_FORM_udata) {
+                    highPC = value.number;
+                    relative = form != DW_FORM_addr;
+                }
+
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if (!statement)
+        return std::nullopt;
+
+    if (low && high && lowPC && highPC) {
+        *low = *lowPC;
+        *high = relative ? *lowPC + *highPC : *highPC;
+    }
+
+    result.offset = *statement;
+    return result;
+}
+
+std::optional<elf::LineTable::Program> elf::LineTable::decode(const Unit &unit) const {
+    auto line = section(".debug_line");
+
+    if (!line.first)
+        return std::nullopt;
+
+    Cursor cursor(line.first, line.second, mEndian);
+    cursor.seek(unit.offset);
+
+    size_t offsetSize = 4;
+    Elf64_Xword length = cursor.read<uint32_t>();
+
+    if (length == 0xffffffff) {
+        offsetSize = 8;
+        length = cursor.read<uint64_t>();
+    }
+
+    if (length > cursor.remaining())
+        return std::nullopt;
+
+    Cursor body(cursor.current(), length, mEndian);
+
+    auto version = body.read<uint16_t>();
+    size_t addressSize = mAddressSize;
+
+    if (version < 2 || version > 5)
+        return std::nullopt;
+
+    if (version == 5) {
+        addressSize = body.read<uint8_t>();
+        body.read<uint8_t>();
+    }
+
+    Elf64_Xword headerLength = offsetSize == 8 ? body.read<uint64_t>() : body.read<uint32_t>();
+    size_t programOffset = body.offset() + headerLength;
+
+    auto minimumLength = body.read<uint8_t>();
+
+    if (version >= 4)
+        body.read<uint8_t>();
+
+    body.read<uint8_t>();
+    auto lineBase = body.read<int8_t>();
+    auto lineRange = body.read<uint8_t>();
+    auto opcodeBase = body.read<uint8_t>();
+
+    if (!lineRange || !opcodeBase)
+        return std::nullopt;
+
+    std::vector<uint8_t> opcodeLengths(opcodeBase - 1);
+
+    for (auto &opcodeLength: opcodeLengths)
+        opcodeLength = body.read<uint8_t>();
+
+    Program program;
+    std::vector<std::string> directories;
+
+    if (version < 5) {
+        directories.push_back(unit.directory);
+
+        while (!body.failed()) {
+            auto directory = body.string();
+
+            if (directory.empty())
+                break;
+
+            directories.push_back(join(unit.directory, directory));
+        }
+
+        // file numbers are one-based before DWARF 5
+        program.files.emplace_back();
+
+        while (!body.failed()) {
+            auto name = body.string();
+
+            if (name.empty())
+                break;
+
+            auto index = body.unsignedLEB128();
+            body.unsignedLEB128();
+            body.unsignedLEB128();
+
+            program.files.push_back(join(index < directories.size() ? directories[index] : "", name));
+        }
+    } else {
+        auto strings = section(".debug_str");
+        auto lineStrings = section(".debug_line_str");
+
+        auto entries = [&](auto &&consume) {
+            std::vector<std::pair<Elf64_Xword, Elf64_Xword>> formats(body.read<uint8_t>());
+
+            for (auto &[type, form]: formats) {
+                type = body.unsignedLEB128();
+                form = body.unsignedLEB128();
+            }
+
+            auto count = body.unsignedLEB128();
+
+            for (Elf64_Xword i = 0; i < count && !body.failed(); i++) {
+                std::string_view path;
+                Elf64_Xword directory = 0;
+
+                for (const auto &[type, form]: formats) {
+                    Value value;
+
+                    if (!attribute(body, form, 0, addressSize, offsetSize, value))
+                        return false;
+
+                    if (type == DW_LNCT_path) {
+                        if (form == DW_FORM_string)
+                            path = value.string;
+                        else if (form == DW_FORM_line_strp)
+                            path = string(lineStrings, value.number);
+                        else if (form == DW_FORM_strp)
+                            path = string(strings, value.number);
+                    } else if (type == DW_LNCT_directory_index) {
+                        directory = value.number;
+                    }
+                }
+
+                consume(path, directory);
+            }
+
+            return !body.failed();
+        };
+
+        if (!entries([&](std::string_view path, Elf64_Xword) {
+            directories.push_back(directories.empty() ? join(unit.directory, path) : join(directories[0], path));
+        }))
+            return std::nullopt;
+
+        if (!entries([&](std::string_view path, Elf64_Xword directory) {
+            program.files.push_back(join(directory < directories.size() ? directories[directory] : "", path));
+        }))
+            return std::nullopt;
+    }
+
+    if (body.failed())
+        return std::nullopt;
+
+    body.seek(programOffset);
+
+    Row state = {0, 1, 1, 0, false};
+    auto reset = [&]() {
+        state = {0, 1, 1, 0, false};
+    };
+
+    while (body.remaining() && !body.failed()) {
+        auto opcode = body.read<uint8_t>();
+
+        if (opcode >= opcodeBase) {
+            unsigned int adjusted = opcode - opcodeBase;
+
+            state.address += (adjusted / lineRange) * minimumLength;
+            state.line += lineBase + (int) (adjusted % lineRange);
+
+            program.rows.push_back(state);
+            continue;
+        }
+
+        switch (opcode) {
+            case 0: {
+                auto size = body.unsignedLEB128();
+                size_t end = body.offset() + size;
+
+                if (!size)
+                    break;
+
+                auto extended = body.read<uint8_t>();
+
+                if (extended == DW_LNE_end_sequence) {
+                    state.end = true;
+                    program.rows.push_back(state);
+                    reset();
+                } else if (extended == DW_LNE_set_address) {
+                    state.address = size - 1 == 8 ? body.read<uint64_t>() : body.read<uint32_t>();
+                } else if (extended == DW_LNE_define_file) {
+                    auto name = body.string();
+                    auto index = body.unsignedLEB128();
+
+                    program.files.push_back(join(index < directories.size() ? directories[index] : "", name));
+                }
+
+                body.seek(end);
+                break;
+            }
+
+            case DW_LNS_copy:
+                program.rows.push_back(state);
+                break;
+
+            case DW_LNS_advance_pc:
+                state.address += body.unsignedLEB128() * minimumLength;
+                break;
+
+            case DW_LNS_advance_line:
+                state.line += body.signedLEB128();
+                break;
+
+            case DW_LNS_set_file:
+                state.file = body.unsignedLEB128();
+                break;
+
+            case DW_LNS_set_column:
+                state.column = body.unsignedLEB128();
+                break;
+
+            case DW_LNS_negate_stmt:
+            case DW_LNS_set_basic_block:
+            case DW_LNS_set_prologue_end:
+            case DW_LNS_set_epilogue_begin:
+                break;
+
+            case DW_LNS_const_add_pc:
+                state.address += ((255 - opcodeBase) / lineRange) * minimumLength;
+                break;
+
+            case DW_LNS_fixed_advance_pc:
+                state.address += body.read<uint16_t>();
+                break;
+
+            default:
+                for (int i = 0; i < opcodeLengths[opcode - 1]; i++)
+                    body.unsignedLEB128();
+
+                break;
+        }
+    }
+
+    // sequences may come in any order, an end row sorts before a sequence starting at the same address
+    std::stable_sort(
+            program.rows.begin(),
+            program.rows.end(),
+            [](const Row &lhs, const Row &rhs) {
+                if (lhs.address != rhs.address)
+                    return lhs.address < rhs.address;
+
+                return lhs.end && !rhs.end;
+            }
+    );
+
+    return program;
+}
+
+void elf::LineTable::index() {
+    std::call_once(mIndexed, [this]() {
+        // compressed debug sections are inflated once and kept alive for the table's lifetime
+        for (const auto &section: mReader.sections()) {
+            if (section->type() == SHT_NOBITS)
+                continue;
+
+            auto name = section->name();
+
+            if (name != ".debug_info" && name != ".debug_abbrev" && name != ".debug_aranges" &&
+                name != ".debug_line" && name != ".debug_str" && name != ".debug_line_str")
+                continue;
+
+            auto buffer = sectionData(mReader, section);
+
+            if (!buffer)
+                continue;
+
+            mBuffers.emplace(name, *buffer);
+        }
+
+        auto sequences = [this](size_t unit) {
+            auto program = decode(mUnits[unit]);
+
+            if (!program)
+                return;
+
+            std::optional<Elf64_Addr> begin;
+
+            // rows are sorted, so adjacent sequences merge into one range
+            for (const auto &row: program->rows) {
+                if (!begin)
+                    begin = row.address;
+
+                if (!row.end)
+                    continue;
+
+                mRanges.push_back({*begin, row.address, unit});
+                begin.reset();
+            }
+
+            std::lock_guard<std::shared_mutex> guard(mMutex);
+            mPrograms.try_emplace(unit, std::move(*program));
+        };
+
+        auto ranges = section(".debug_aranges");
+        auto info = section(".debug_info");
+
+        if (ranges.first && info.first) {
+            std::map<Elf64_Off, std::optional<size_t>> units;
+            Cursor cursor(ranges.first, ranges.second, mEndian);
+
+            while (cursor.remaining() && !cursor.failed()) {
+                size_t offsetSize = 4;
+                Elf64_Xword length = cursor.read<uint32_t>();
+
+                if (length == 0xffffffff) {
+                    offsetSize = 8;
+                    length = cursor.read<uint64_t>();
+                }
+
+                if (!length || length > cursor.remaining())
+                    break;
+
+                Cursor body(cursor.current(), length, mEndian);
+                cursor.skip(length);
+
+                body.read<uint16_t>();
+                Elf64_Off offset = offsetSize == 8 ? body.read<uint64_t>() : body.read<uint32_t>();
+                auto addressSize = body.read<uint8_t>();
+                body.read<uint8_t>();
+
+                if (addressSize != 4 && addressSize != 8)
+                    continue;
+
+                // tuples are aligned to twice the address size from the start of the set
+                size_t header = (offsetSize == 8 ? 12 : 4) + body.offset();
+                size_t padding = (2 * addressSize - header % (2 * addressSize)) % (2 * addressSize);
+                body.skip(padding);
+
+                auto it = units.find(offset);
+
+                if (it == units.end()) {
+                    auto result = unit(offset, nullptr, nullptr);
+
+                    if (result) {
+                        mUnits.push_back(std::move(*result));
+                        it = units.emplace(offset, mUnits.size() - 1).first;
+                    } else {
+                        it = units.emplace(offset, std::nullopt).first;
+                    }
+                }
+
+                while (body.remaining() && !body.failed()) {
+                    Elf64_Addr address = addressSize == 8 ? body.read<uint64_t>() : body.read<uint32_t>();
+                    Elf64_Xword size = addressSize == 8 ? body.read<uint64_t>() : body.read<uint32_t>();
+
+                    if (!address && !size)
+                        break;
+
+                    if (it->second && size)
+                        mRanges.push_back({address, address + size, *it->second});
+                }
+            }
+        } else if (info.first) {
+            Cursor cursor(info.first, info.second, mEndian);
+
+            while (cursor.remaining() && !cursor.failed()) {
+                size_t offset = cursor.offset();
+                Elf64_Xword length = cursor.read<uint32_t>();
+
+                if (length == 0xffffffff)
+                    length = cursor.read<uint64_t>();
+
+                if (!length || length > cursor.remaining())
+                    break;
+
+                cursor.skip(length);
+
+                Elf64_Addr low = 0;
+                Elf64_Addr high = 0;
+                auto result = unit(offset, &low, &high);
+
+                if (!result)
+                    continue;
+
+                mUnits.push_back(std::move(*result));
+
+                if (high > low)
+                    mRanges.push_back({low, high, mUnits.size() - 1});
+                else
+                    sequences(mUnits.size() - 1);
+            }
+        } else {
+            auto line = section(".debug_line");
+            Cursor cursor(line.first, line.second, mEndian);
+
+            while (line.first && cursor.remaining() && !cursor.failed()) {
+                size_t offset = cursor.offset();
+                Elf64_Xword length = cursor.read<uint32_t>();
+
+                if (length == 0xffffffff)
+                    length = cursor.read<uint64_t>();
+
+                if (!length || length > cursor.remaining())
+                    break;
+
+                cursor.skip(length);
+
+                mUnits.push_back({offset, {}});
+                sequences(mUnits.size() - 1);
+            }
+        }
+
+        std::sort(
+                mRanges.begin(),
+                mRanges.end(),
+                [](const Range &lhs, const Range &rhs) {
+                    return lhs.begin < rhs.begin;
+                }
+        );
+    });
+}
+
+const elf::LineTable::Range *elf::LineTable::range(Elf64_Addr address) {
+    auto it = std::upper_bound(
+            mRanges.begin(),
+            mRanges.end(),
+            address,
+            [](Elf64_Addr address, const Range &range) {
+                return address < range.begin;
+            }
+    );
+
+    if (it == mRanges.begin() || address >= std::prev(it)->end)
+        return nullptr;
+
+    return &*std::prev(it);
+}
+
+const elf::LineTable::Program *elf::LineTable::program(size_t unit) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mMutex);
+        auto it = mPrograms.find(unit);
+
+        if (it != mPrograms.end())
+            return &it->second;
+    }
+
+    auto program = decode(mUnits[unit]);
+
+    std::lock_guard<std::shared_mutex> guard(mMutex);
+    return &mPrograms.try_emplace(unit, program ? std::move(*program) : Program{}).first->second;
+}
+
+std::pair<std::vector<elf::LineTable::Row>::const_iterator, std::optional<elf::Line>>
+elf::LineTable::lookup(const Program &program, std::vector<Row>::const_iterator hint, Elf64_Addr address) {
+    auto it = std::upper_bound(
+            hint,
+            program.rows.end(),
+            address,
+            [](Elf64_Addr address, const Row &row) {
+                return address < row.address;
+            }
+    );
+
+    if (it == program.rows.begin() || std::prev(it)->end)
+        return {it, std::nullopt};
+
+    const Row &row = *std::prev(it);
+
+    return {
+            it,
+            Line{
+                    row.address,
+                    row.file < program.files.size() ? std::string_view(program.files[row.file]) : std::string_view(),
+                    row.line,
+                    row.column
+            }
+    };
+}
+
+std::optional<elf::Line> elf::LineTable::find(Elf64_Addr address) {
+    index();
+
+    auto current = range(address);
+
+    if (!current)
+        return std::nullopt;
+
+    auto program = this->program(current->unit);
+    return lookup(*program, program->rows.begin(), address).second;
+}
+
+std::vector<std::optional<elf::Line>> elf::LineTable::find(const std::vector<Elf64_Addr> &addresses) {
+    index();
+
+    std::vector<std::optional<Line>> lines(addresses.size());
+    std::vector<size_t> order(addresses.size());
+
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+
+    // visiting addresses in ascending order lets each search resume from the previous row
+    std::stable_sort(
+            order.begin(),
+            order.end(),
+            [&](size_t lhs, size_t rhs) {
+                return addresses[lhs] < addresses[rhs];
+            }
+    );
+
+    const Range *current = nullptr;
+    const Program *program = nullptr;
+    std::vector<Row>::const_iterator hint;
+
+    for (const auto &index: order) {
+        Elf64_Addr address = addresses[index];
+
+        if (!current || address < current->begin || address >= current->end) {
+            current = range(address);
+
+            if (!current)
+                continue;
+
+            program = this->program(current->unit);
+            hint = program->rows.begin();
+        }
+
+        auto [it, line] = lookup(*program, hint, address);
+
+        hint = it;
+        lines[index] = line;
+    }
+
+    return lines;
+}
@@ -0,0 +1,68 @@
+#include "mapping.h"
+#include <elf/error.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+tl::expected<elf::Mapping, std::error_code> elf::mapFile(int fd, size_t length) {
+    if (!length)
+        return Mapping{nullptr, 0};
+
+    void *buffer = mmap(
+            nullptr,
+            length,
+            PROT_READ,
+            MAP_PRIVATE,
+            fd,
+            0
+    );
+
+    if (buffer == MAP_FAILED)
+        return tl::unexpected(std::error_code(errno, std::system_category()));
+
+    return Mapping{
+            std::shared_ptr<void>(buffer, [=](void *ptr) {
+                munmap(ptr, length);
+            }),
+            length
+    };
+}
+
+tl::expected<elf::Mapping, std::error_code> elf::mapFile(const std::filesystem::path &path) {
+    std::error_code ec;
+    size_t length = std::filesystem::file_size(path, ec);
+
+    if (ec)
+        return tl::unexpected(ec);
+
+    int fd = open(path.string().c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+        return tl::unexpected(std::error_code(errno, std::system_category()));
+
+    auto mapping = mapFile(fd, length);
+    close(fd);
+
+    return mapping;
+}
+
+std::error_code elf::checkIdent(const std::byte *data, size_t length) {
+    if (length < EI_NIDENT)
+        return Error::INVALID_ELF_HEADER;
+
+    auto ident = (const unsigned char *) data;
+
+    if (ident[EI_MAG0] != ELFMAG0 ||
+        ident[EI_MAG1] != ELFMAG1 ||
+        ident[EI_MAG2] != ELFMAG2 ||
+        ident[EI_MAG3] != ELFMAG3)
+        return Error::INVALID_ELF_MAGIC;
+
+    if (ident[EI_CLASS] != ELFCLASS64 && ident[EI_CLASS] != ELFCLASS32)
+        return Error::INVALID_ELF_CLASS;
+
+    if (ident[EI_DATA] != ELFDATA2LSB && ident[EI_DATA] != ELFDATA2MSB)
+        return Error::INVALID_ELF_ENDIAN;
+
+    return {};
+}
@@ -0,0 +1,25 @@
+#ifndef ELF_MAPPING_H
+#define ELF_MAPPING_H
+
+#include <elf.h>
+#include <memory>
+#include <filesystem>
+#include <system_error>
+#include <tl/expected.hpp>
+
+namespace elf {
+    struct Mapping {
+        std::shared_ptr<void> buffer;
+        size_t length;
+    };
+
+    // read-only private mapping of the first length bytes of fd, unmapped with its last reference. empty files map to
+    // a null buffer, the descriptor may be closed as soon as this returns.
+    tl::expected<Mapping, std::error_code> mapFile(int fd, size_t length);
+    tl::expected<Mapping, std::error_code> mapFile(const std::filesystem::path &path);
+
+    // the e_ident checks every reader front end applies before trusting a buffer
+    std::error_code checkIdent(const std::byte *data, size_t length);
+}
+
+#endif //ELF_MAPPING_H
@@ -0,0 +1,184 @@
+#include <elf/minidebug.h>
+#include <elf/note.h>
+#include <elf/error.h>
+#include <lzma.h>
+
+constexpr auto XZ_MEMORY_LIMIT = 256 * 1024 * 1024;
+constexpr auto MAX_MINI_DEBUG_SIZE = 1024 * 1024 * 1024;
+
+static tl::expected<std::vector<std::byte>, std::error_code> inflate(const std::byte *data, Elf64_Xword size) {
+    lzma_stream stream = LZMA_STREAM_INIT;
+
+    if (lzma_stream_decoder(&stream, XZ_MEMORY_LIMIT, 0) != LZMA_OK)
+        return tl::unexpected(elf::Error::DECOMPRESSION_FAILED);
+
+    std::unique_ptr<lzma_stream, decltype(&lzma_end)> guard(&stream, lzma_end);
+    std::vector<std::byte> buffer(std::max<Elf64_Xword>(size * 4, 4096));
+
+    stream.next_in = (const uint8_t *) data;
+    stream.avail_in = size;
+    stream.next_out = (uint8_t *) buffer.data();
+    stream.avail_out = buffer.size();
+
+    while (true) {
+        lzma_ret status = lzma_code(&stream, LZMA_FINISH);
+
+        if (status == LZMA_STREAM_END)
+            break;
+
+        if (status != LZMA_OK || stream.avail_out)
+            return tl::unexpected(elf::Error::DECOMPRESSION_FAILED);
+
+        // the xz index is at the end of the stream, so the output grows as it goes
+        size_t used = buffer.size();
+
+        if (used >= MAX_MINI_DEBUG_SIZE)
+            return tl::unexpected(elf::Error::DECOMPRESSION_FAILED);
+
+        buffer.resize(std::min<size_t>(used * 2, MAX_MINI_DEBUG_SIZE));
+
+        stream.next_out = (uint8_t *) buffer.data() + used;
+        stream.avail_out = buffer.size() - used;
+    }
+
+    buffer.resize(stream.total_out);
+    return buffer;
+}
+
+static std::string hex(const std::vector<std::byte> &bytes) {
+    constexpr auto DIGITS = "0123456789abcdef";
+
+    std::string result;
+
+    for (const auto &byte: bytes) {
+        result.push_back(DIGITS[std::to_integer<unsigned>(byte) >> 4]);
+        result.push_back(DIGITS[std::to_integer<unsigned>(byte) & 0xf]);
+    }
+
+    return result;
+}
+
+static bool mapped(const std::string &key) {
+    return key.compare(0, 4, "map:") == 0;
+}
+
+elf::MiniDebugCache::MiniDebugCache() : mGeneration(0) {
+
+}
+
+std::optional<elf::Reader> elf::MiniDebugCache::get(const Reader &reader) {
+    auto section = reader.section(".gnu_debugdata");
+
+    if (!section || section->type() == SHT_NOBITS)
+        return std::nullopt;
+
+    // the same module opened twice shares its build id, anything else only lives as long as its mapping
+    auto id = buildID(reader);
+    std::string key = id ? "id:" + hex(*id) : "map:" + std::to_string((uintptr_t) section->data());
+
+    std::promise<std::optional<Reader>> promise;
+    std::shared_future<std::optional<Reader>> future;
+    std::optional<size_t> generation;
+
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        auto it = mEntries.find(key);
+
+        if (it != mEntries.end() && (id || !it->second.owner.expired())) {
+            future = it->second.future;
+        } else {
+            // addresses of unmapped modules are reused, their entries would only pile up
+            for (auto entry = mEntries.begin(); entry != mEntries.end();) {
+                if (mapped(entry->first) && entry->second.owner.expired())
+                    entry = mEntries.erase(entry);
+                else
+                    entry++;
+            }
+
+            generation = mGeneration++;
+            future = promise.get_future().share();
+
+            mEntries.insert_or_assign(key, Entry{*generation, id ? std::weak_ptr<void>() : reader.buffer(), future});
+        }
+    }
+
+    if (generation) {
+        std::optional<Reader> result;
+        std::exception_ptr exception;
+        bool failed = false;
+
+        // waiters must never be left with a broken promise, a forged image can make the allocation throw
+        try {
+            auto debug = openMiniDebugInfo(reader);
+
+            if (debug)
+                result = std::move(*debug);
+        } catch (const std::bad_alloc &) {
+            failed = true;
+        } catch (const std::length_error &) {
+            failed = true;
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        if (exception)
+            promise.set_exception(exception);
+        else
+            promise.set_value(std::move(result));
+
+        // a failure that is not about the image itself may pass on a later call
+        if (exception || failed) {
+            std::lock_guard<std::mutex> guard(mMutex);
+            auto it = mEntries.find(key);
+
+            if (it != mEntries.end() && it->second.id == *generation)
+                mEntries.erase(it);
+        }
+    }
+
+    return future.get();
+}
+
+size_t elf::MiniDebugCache::size() {
+    std::lock_guard<std::mutex> guard(mMutex);
+    return mEntries.size();
+}
+
+void elf::MiniDebugCache::clear() {
+    std::lock_guard<std::mutex> guard(mMutex);
+    mEntries.clear();
+}
+
+elf::MiniDebugCache &elf::miniDebugCache() {
+    static MiniDebugCache instance;
+    return instance;
+}
+
+tl::expected<elf::Reader, std::error_code> elf::openMiniDebugInfo(const Reader &reader) {
+    auto section = reader.section(".gnu_debugdata");
+
+    if (!section || section->type() == SHT_NOBITS)
+        return tl::unexpected(make_error_code(std::errc::no_such_file_or_directory));
+
+    auto data = inflate(section->data(), section->size());
+
+    if (!data)
+        return tl::unexpected(data.error());
+
+    auto buffer = std::make_shared<std::vector<std::byte>>(std::move(*data));
+
+    return openMemory(std::shared_ptr<void>(buffer, buffer->data()), buffer->size());
+}
+
+std::optional<elf::Reader> elf::miniDebugInfo(const Reader &reader) {
+    return miniDebugCache().get(reader);
+}
+
+std::vector<elf::AddressRange> elf::miniDebugRanges(const Reader &reader, bool demangle) {
+    auto debug = miniDebugInfo(reader);
+
+    if (!debug)
+        return {};
+
+    return symbolRanges(*debug, demangle);
+}
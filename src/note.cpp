@@ -0,0 +1,162 @@
+#include <elf/note.h>
+#include <cstring>
+
+static size_t alignUp(size_t value, size_t align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+template<elf::endian::Type Endian>
+elf::Note<Endian>::Note(const Elf64_Nhdr *note, size_t align) : mAlign(align), mHeader(), mNote(note) {
+    std::memcpy(&mHeader, note, sizeof(Elf64_Nhdr));
+}
+
+template<elf::endian::Type Endian>
+std::string_view elf::Note<Endian>::name() {
+    auto name = (const char *) mNote + sizeof(Elf64_Nhdr);
+    return {name, strnlen(name, nameSize())};
+}
+
+template<elf::endian::Type Endian>
+const std::byte *elf::Note<Endian>::descriptor() {
+    return (const std::byte *) mNote + alignUp(sizeof(Elf64_Nhdr) + nameSize(), mAlign);
+}
+
+template<elf::endian::Type Endian>
+Elf64_Word elf::Note<Endian>::nameSize() {
+    return endian::convert<Endian>(mHeader.n_namesz);
+}
+
+template<elf::endian::Type Endian>
+Elf64_Word elf::Note<Endian>::descriptorSize() {
+    return endian::convert<Endian>(mHeader.n_descsz);
+}
+
+template<elf::endian::Type Endian>
+Elf64_Word elf::Note<Endian>::type() {
+    return endian::convert<Endian>(mHeader.n_type);
+}
+
+elf::NoteIterator::NoteIterator(const std::byte *note, const std::byte *end, size_t align, endian::Type endian)
+        : mAlign(align), mEndian(endian), mNote(note), mEnd(end) {
+    if (!length())
+        mNote = mEnd;
+}
+
+size_t elf::NoteIterator::length() const {
+    if (mNote >= mEnd || (size_t) (mEnd - mNote) < sizeof(Elf64_Nhdr))
+        return 0;
+
+    Elf64_Nhdr note;
+    std::memcpy(&note, mNote, sizeof(Elf64_Nhdr));
+
+    Elf64_Word nameSize = mEndian == endian::Little ?
+                          endian::convert<endian::Little>(note.n_namesz) :
+                          endian::convert<endian::Big>(note.n_namesz);
+
+    Elf64_Word descriptorSize = mEndian == endian::Little ?
+                                endian::convert<endian::Little>(note.n_descsz) :
+                                endian::convert<endian::Big>(note.n_descsz);
+
+    size_t length = alignUp(alignUp(sizeof(Elf64_Nhdr) + nameSize, mAlign) + descriptorSize, mAlign);
+
+    // the last note may omit its trailing padding
+    if (alignUp(sizeof(Elf64_Nhdr) + nameSize, mAlign) + descriptorSize > (size_t) (mEnd - mNote))
+        return 0;
+
+    return std::min(length, (size_t) (mEnd - mNote));
+}
+
+std::unique_ptr<elf::INote> elf::NoteIterator::operator*() {
+    if (mEndian == endian::Little)
+        return std::make_unique<Note<endian::Little>>((const Elf64_Nhdr *) mNote, mAlign);
+
+    return std::make_unique<Note<endian::Big>>((const Elf64_Nhdr *) mNote, mAlign);
+}
+
+elf::NoteIterator &elf::NoteIterator::operator++() {
+    mNote += length();
+
+    if (!length())
+        mNote = mEnd;
+
+    return *this;
+}
+
+bool elf::NoteIterator::operator==(const elf::NoteIterator &rhs) {
+    return mNote == rhs.mNote;
+}
+
+bool elf::NoteIterator::operator!=(const elf::NoteIterator &rhs) {
+    return !operator==(rhs);
+}
+
+elf::NoteTable::NoteTable(elf::Reader reader, std::shared_ptr<ISection> section)
+        : mReader(std::move(reader)), mAlign(section->addressAlign() == 8 ? 8 : 4), mSize(section->size()),
+          mData(section->data()) {
+
+}
+
+elf::NoteTable::NoteTable(elf::Reader reader, std::shared_ptr<ISegment> segment)
+        : mReader(std::move(reader)), mAlign(segment->align() == 8 ? 8 : 4), mSize(segment->fileSize()),
+          mData(segment->data()) {
+
+}
+
+elf::NoteIterator elf::NoteTable::begin() {
+    return {
+            mData,
+            mData + mSize,
+            mAlign,
+            mReader.header()->ident()[EI_DATA] == ELFDATA2LSB ? endian::Little : endian::Big
+    };
+}
+
+elf::NoteIterator elf::NoteTable::end() {
+    return {
+            mData + mSize,
+            mData + mSize,
+            mAlign,
+            mReader.header()->ident()[EI_DATA] == ELFDATA2LSB ? endian::Little : endian::Big
+    };
+}
+
+std::optional<std::vector<std::byte>> elf::buildID(const elf::Reader &reader) {
+    auto find = [](NoteTable table) -> std::optional<std::vector<std::byte>> {
+        for (const auto &note: table) {
+            if (note->type() != NT_GNU_BUILD_ID || note->name() != "GNU")
+                continue;
+
+            return std::vector<std::byte>{note->descriptor(), note->descriptor() + note->descriptorSize()};
+        }
+
+        return std::nullopt;
+    };
+
+    for (const auto &segment: reader.segments()) {
+        if (segment->type() != PT_NOTE)
+            continue;
+
+        auto id = find({reader, segment});
+
+        if (id)
+            return id;
+    }
+
+    for (const auto &section: reader.sections()) {
+        if (section->type() != SHT_NOTE)
+            continue;
+
+        auto id = find({reader, section});
+
+        if (id)
+            return id;
+    }
+
+    return std::nullopt;
+}
+
+template
+class elf::Note<elf::endian::Little>;
+
+template
+class elf::Note<elf::endian::Big>;
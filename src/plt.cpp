@@ -0,0 +1,152 @@
+#include <elf/plt.h>
+#include <elf/relocation.h>
+#include "cursor.h"
+#include <unordered_map>
+
+constexpr auto X86_64_PLT_ENTRY_SIZE = 16;
+
+constexpr auto AARCH64_BTI_C = 0xd503245f;
+constexpr auto AARCH64_ADRP_X16_MASK = 0x9f00001f;
+constexpr auto AARCH64_ADRP_X16 = 0x90000010;
+constexpr auto AARCH64_LDR_X17_X16_MASK = 0xffc003ff;
+constexpr auto AARCH64_LDR_X17_X16 = 0xf9400211;
+
+using Slots = std::unordered_map<Elf64_Addr, std::string_view>;
+
+// got slot of every dynamic JUMP_SLOT and GLOB_DAT relocation, one pass over the tables
+static Slots slots(const elf::Reader &reader, Elf64_Half machine) {
+    Slots slots;
+
+    for (const auto &section: reader.sections()) {
+        if (section->type() != SHT_RELA && section->type() != SHT_REL)
+            continue;
+
+        auto symbols = reader.section(section->link());
+
+        if (!symbols || symbols->type() != SHT_DYNSYM || !section->entrySize())
+            continue;
+
+        for (const auto &relocation: elf::RelocationTable(reader, section).views()) {
+            if (!relocation.symbol || relocation.symbol->name.empty())
+                continue;
+
+            if (machine == EM_X86_64 &&
+                relocation.type != R_X86_64_JUMP_SLOT && relocation.type != R_X86_64_GLOB_DAT)
+                continue;
+
+            if (machine == EM_AARCH64 &&
+                relocation.type != R_AARCH64_JUMP_SLOT && relocation.type != R_AARCH64_GLOB_DAT)
+                continue;
+
+            slots.emplace(relocation.offset, relocation.symbol->name);
+        }
+    }
+
+    return slots;
+}
+
+// fixed-size stubs each holding a jmp *disp32(%rip), possibly behind endbr64 and bnd prefixes
+static void x86_64(elf::ISection &stubs, const Slots &slots, std::vector<elf::AddressRange> &ranges) {
+    Elf64_Xword size = stubs.size();
+    Elf64_Xword stride = stubs.entrySize() ? stubs.entrySize() : X86_64_PLT_ENTRY_SIZE;
+
+    elf::Cursor cursor(stubs.data(), size, elf::endian::Little);
+
+    for (Elf64_Xword offset = 0; stride <= size - offset; offset += stride) {
+        for (Elf64_Xword i = offset; i + 6 <= offset + stride; i++) {
+            cursor.seek(i);
+
+            if (cursor.read<unsigned char>() != 0xff || cursor.read<unsigned char>() != 0x25)
+                continue;
+
+            auto slot = stubs.address() + i + 6 + (Elf64_Sxword) cursor.read<int32_t>();
+            auto it = slots.find(slot);
+
+            if (it != slots.end())
+                ranges.push_back({stubs.address() + offset, stride, std::string(it->second) + "@plt"});
+
+            break;
+        }
+    }
+}
+
+// stubs load their slot with adrp x16 followed by ldr x17, [x16, #imm], optionally preceded by bti c
+static void aarch64(elf::ISection &stubs, const Slots &slots, std::vector<elf::AddressRange> &ranges) {
+    Elf64_Xword size = stubs.size() & ~3;
+    elf::Cursor cursor(stubs.data(), size, elf::endian::Little);
+
+    std::vector<std::pair<Elf64_Xword, Elf64_Addr>> entries;
+
+    for (Elf64_Xword offset = 0; offset + 8 <= size; offset += 4) {
+        cursor.seek(offset);
+
+        auto adrp = cursor.read<Elf32_Word>();
+        auto ldr = cursor.read<Elf32_Word>();
+
+        if ((adrp & AARCH64_ADRP_X16_MASK) != AARCH64_ADRP_X16 ||
+            (ldr & AARCH64_LDR_X17_X16_MASK) != AARCH64_LDR_X17_X16)
+            continue;
+
+        auto immediate = (Elf64_Sxword) ((((adrp >> 5) & 0x7ffff) << 2) | ((adrp >> 29) & 3));
+
+        if (immediate & (1 << 20))
+            immediate -= 1 << 21;
+
+        Elf64_Addr page = ((stubs.address() + offset) & ~(Elf64_Addr) 0xfff) + immediate * 4096;
+        Elf64_Addr slot = page + ((ldr >> 10) & 0xfff) * 8;
+
+        Elf64_Xword start = offset;
+
+        if (offset >= 4) {
+            cursor.seek(offset - 4);
+
+            if (cursor.read<Elf32_Word>() == AARCH64_BTI_C)
+                start = offset - 4;
+        }
+
+        entries.emplace_back(start, slot);
+        offset += 4;
+    }
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        auto it = slots.find(entries[i].second);
+
+        if (it == slots.end())
+            continue;
+
+        Elf64_Xword end = i + 1 < entries.size() ? entries[i + 1].first : size;
+
+        ranges.push_back({
+                stubs.address() + entries[i].first,
+                end - entries[i].first,
+                std::string(it->second) + "@plt"
+        });
+    }
+}
+
+std::vector<elf::AddressRange> elf::pltRanges(const Reader &reader) {
+    Elf64_Half machine = reader.header()->machine();
+
+    if (machine != EM_X86_64 && machine != EM_AARCH64)
+        return {};
+
+    std::vector<AddressRange> ranges;
+    std::optional<Slots> got;
+
+    for (const auto &name: {".plt", ".plt.sec", ".plt.got"}) {
+        auto section = reader.section(name);
+
+        if (!section || section->type() != SHT_PROGBITS || !section->size())
+            continue;
+
+        if (!got)
+            got = slots(reader, machine);
+
+        if (machine == EM_X86_64)
+            x86_64(*section, *got, ranges);
+        else
+            aarch64(*section, *got, ranges);
+    }
+
+    return ranges;
+}
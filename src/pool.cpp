@@ -0,0 +1,168 @@
+#include <elf/pool.h>
+#include <algorithm>
+
+static bool same(const struct stat &st, dev_t device, ino_t inode, off_t size, const timespec &modified) {
+    return st.st_dev == device &&
+           st.st_ino == inode &&
+           st.st_size == size &&
+           st.st_mtim.tv_sec == modified.tv_sec &&
+           st.st_mtim.tv_nsec == modified.tv_nsec;
+}
+
+elf::ReaderPool::ReaderPool(size_t maxMappings, size_t maxBytes) : mState(std::make_shared<State>()) {
+    mState->maxMappings = maxMappings;
+    mState->maxBytes = maxBytes;
+    mState->mappings = 0;
+    mState->bytes = 0;
+}
+
+tl::expected<elf::Reader, std::error_code> elf::ReaderPool::open(const std::filesystem::path &path) {
+    std::error_code ec;
+    std::string key = std::filesystem::absolute(path, ec).lexically_normal().string();
+
+    if (ec)
+        return tl::unexpected(ec);
+
+    struct stat st = {};
+
+    if (stat(path.string().c_str(), &st) < 0)
+        return tl::unexpected(std::error_code(errno, std::system_category()));
+
+    auto &state = *mState;
+    size_t size = st.st_size;
+
+    std::unique_lock<std::mutex> lock(state.mutex);
+
+    while (true) {
+        auto it = state.index.find(key);
+
+        if (it == state.index.end())
+            break;
+
+        auto entry = it->second;
+
+        if (!same(st, entry->device, entry->inode, (off_t) entry->size, entry->modified)) {
+            retire(state, entry);
+            continue;
+        }
+
+        // another thread is still mapping this file
+        if (!entry->buffer) {
+            state.condition.wait(lock);
+            continue;
+        }
+
+        state.entries.splice(state.entries.begin(), state.entries, entry);
+        return lease(mState, entry);
+    }
+
+    // with every mapping leased the limits are exceeded instead of waiting, the caller may hold those leases itself
+    while (state.mappings &&
+           (state.mappings >= state.maxMappings || state.bytes + size > state.maxBytes) &&
+           evict(state));
+
+    auto it = state.entries.insert(
+            state.entries.begin(),
+            Entry{key, st.st_dev, st.st_ino, size, st.st_mtim, 0, false, nullptr}
+    );
+
+    state.index.emplace(key, it);
+    state.mappings++;
+    state.bytes += size;
+
+    lock.unlock();
+    auto reader = openFile(path);
+    lock.lock();
+
+    state.condition.notify_all();
+
+    if (!reader) {
+        erase(state, it);
+        return tl::unexpected(reader.error());
+    }
+
+    it->buffer = reader->buffer();
+
+    return lease(mState, it);
+}
+
+size_t elf::ReaderPool::mappings() {
+    std::lock_guard<std::mutex> guard(mState->mutex);
+    return mState->mappings;
+}
+
+size_t elf::ReaderPool::bytes() {
+    std::lock_guard<std::mutex> guard(mState->mutex);
+    return mState->bytes;
+}
+
+void elf::ReaderPool::clear() {
+    std::lock_guard<std::mutex> guard(mState->mutex);
+    while (evict(*mState));
+}
+
+elf::Reader elf::ReaderPool::lease(const std::shared_ptr<State> &state, std::list<Entry>::iterator it) {
+    it->leases++;
+
+    return Reader(
+            std::shared_ptr<void>(it->buffer.get(), [state, it](void *) {
+                release(*state, it);
+            }),
+            it->size
+    );
+}
+
+void elf::ReaderPool::release(State &state, std::list<Entry>::iterator it) {
+    std::lock_guard<std::mutex> guard(state.mutex);
+
+    if (--it->leases)
+        return;
+
+    if (it->stale)
+        erase(state, it);
+
+    while ((state.mappings > state.maxMappings || state.bytes > state.maxBytes) && evict(state));
+}
+
+// a replaced file leaves the index at once, its mapping goes when the last lease does
+void elf::ReaderPool::retire(State &state, std::list<Entry>::iterator it) {
+    if (!it->leases && it->buffer) {
+        erase(state, it);
+        return;
+    }
+
+    auto index = state.index.find(it->path);
+
+    if (index != state.index.end() && index->second == it)
+        state.index.erase(index);
+
+    it->stale = true;
+}
+
+void elf::ReaderPool::erase(State &state, std::list<Entry>::iterator it) {
+    auto index = state.index.find(it->path);
+
+    if (index != state.index.end() && index->second == it)
+        state.index.erase(index);
+
+    state.mappings--;
+    state.bytes -= it->size;
+    state.entries.erase(it);
+}
+
+bool elf::ReaderPool::evict(State &state) {
+    auto it = std::find_if(
+            state.entries.rbegin(),
+            state.entries.rend(),
+            [](const auto &entry) {
+                return !entry.leases && entry.buffer;
+            }
+    );
+
+    if (it == state.entries.rend())
+        return false;
+
+    erase(state, std::next(it).base());
+
+    return true;
+}
@@ -1,102 +1,147 @@
 #include <elf/reader.h>
 #include <elf/error.h>
-#include <fcntl.h>
-#include <unistd.h>
-#include <sys/mman.h>
+#include "mapping.h"
 #include <filesystem>
 #include <algorithm>
 
-elf::Reader::Reader(std::shared_ptr<void> buffer) : mBuffer(std::move(buffer)) {
+elf::Reader::Reader(std::shared_ptr<void> buffer, size_t length)
+        : mBuffer(std::move(buffer)), mLength(length), mContext(std::make_shared<Context>()) {
+    auto ident = (const unsigned char *) mBuffer.get();
 
-}
-
-std::unique_ptr<elf::IHeader> elf::Reader::header() const {
-    auto ident = (unsigned char *) mBuffer.get();
+    if (!ident)
+        return;
 
+    // built once so header() is a plain load on every later call
     if (ident[EI_CLASS] == ELFCLASS64) {
         if (ident[EI_DATA] == ELFDATA2LSB)
-            return std::make_unique<Header<Elf64_Ehdr, endian::Little>>((const Elf64_Ehdr *) mBuffer.get());
+            mContext->header = std::make_shared<Header<Elf64_Ehdr, endian::Little>>((const Elf64_Ehdr *) ident);
         else
-            return std::make_unique<Header<Elf64_Ehdr, endian::Big>>((const Elf64_Ehdr *) mBuffer.get());
+            mContext->header = std::make_shared<Header<Elf64_Ehdr, endian::Big>>((const Elf64_Ehdr *) ident);
     } else {
         if (ident[EI_DATA] == ELFDATA2LSB)
-            return std::make_unique<Header<Elf32_Ehdr, endian::Little>>((const Elf32_Ehdr *) mBuffer.get());
+            mContext->header = std::make_shared<Header<Elf32_Ehdr, endian::Little>>((const Elf32_Ehdr *) ident);
         else
-            return std::make_unique<Header<Elf32_Ehdr, endian::Big>>((const Elf32_Ehdr *) mBuffer.get());
+            mContext->header = std::make_shared<Header<Elf32_Ehdr, endian::Big>>((const Elf32_Ehdr *) ident);
     }
 }
 
-std::vector<std::shared_ptr<elf::ISegment>> elf::Reader::segments() const {
-    auto header = this->header();
-    std::vector<std::shared_ptr<elf::ISegment>> segments;
-
-    for (Elf64_Half i = 0; i < header->segmentNum(); i++) {
-        if (header->ident()[EI_CLASS] == ELFCLASS64) {
-            auto segment = (const Elf64_Phdr *) (
-                    (const std::byte *) mBuffer.get() +
-                    header->segmentOffset() +
-                    i * header->segmentEntrySize()
-            );
-
-            if (header->ident()[EI_DATA] == ELFDATA2LSB)
-                segments.push_back(std::make_shared<Segment<Elf64_Phdr, endian::Little>>(segment, mBuffer));
-            else
-                segments.push_back(std::make_shared<Segment<Elf64_Phdr, endian::Big>>(segment, mBuffer));
-        } else {
-            auto segment = (const Elf32_Phdr *) (
-                    (const std::byte *) mBuffer.get() +
-                    header->segmentOffset() +
-                    i * header->segmentEntrySize()
-            );
-
-            if (header->ident()[EI_DATA] == ELFDATA2LSB)
-                segments.push_back(std::make_shared<Segment<Elf32_Phdr, endian::Little>>(segment, mBuffer));
-            else
-                segments.push_back(std::make_shared<Segment<Elf32_Phdr, endian::Big>>(segment, mBuffer));
-        }
-    }
+const std::shared_ptr<void> &elf::Reader::buffer() const {
+    return mBuffer;
+}
+
+size_t elf::Reader::length() const {
+    return mLength;
+}
 
-    return segments;
+const std::shared_ptr<elf::IHeader> &elf::Reader::header() const {
+    return mContext->header;
 }
 
-std::vector<std::shared_ptr<elf::ISection>> elf::Reader::sections() const {
-    auto header = this->header();
-    std::vector<std::shared_ptr<elf::ISection>> sections;
-
-    for (Elf64_Half i = 0; i < header->sectionNum(); i++) {
-        if (header->ident()[EI_CLASS] == ELFCLASS64) {
-            auto section = (const Elf64_Shdr *) (
-                    (std::byte *) mBuffer.get() +
-                    header->sectionOffset() +
-                    i * header->sectionEntrySize()
-            );
-
-            if (header->ident()[EI_DATA] == ELFDATA2LSB)
-                sections.push_back(std::make_shared<Section<Elf64_Shdr, endian::Little>>(section, mBuffer));
-            else
-                sections.push_back(std::make_shared<Section<Elf64_Shdr, endian::Big>>(section, mBuffer));
-        } else {
-            auto section = (const Elf32_Shdr *) (
-                    (std::byte *) mBuffer.get() +
-                    header->sectionOffset() +
-                    i * header->sectionEntrySize()
-            );
-
-            if (header->ident()[EI_DATA] == ELFDATA2LSB)
-                sections.push_back(std::make_shared<Section<Elf32_Shdr, endian::Little>>(section, mBuffer));
-            else
-                sections.push_back(std::make_shared<Section<Elf32_Shdr, endian::Big>>(section, mBuffer));
+const std::vector<std::shared_ptr<elf::ISegment>> &elf::Reader::segments() const {
+    std::call_once(mContext->segmentsOnce, [this]() {
+        auto header = this->header();
+        size_t num = header->segmentNum();
+
+        auto buffer = (const std::byte *) mBuffer.get();
+
+        auto &segments = mContext->segments;
+        segments.reserve(num);
+
+        for (size_t i = 0; i < num; i++) {
+            if (header->ident()[EI_CLASS] == ELFCLASS64) {
+                auto segment = (const Elf64_Phdr *) (
+                        buffer +
+                        header->segmentOffset() +
+                        i * header->segmentEntrySize()
+                );
+
+                if (header->ident()[EI_DATA] == ELFDATA2LSB)
+                    segments.push_back(std::make_shared<Segment<Elf64_Phdr, endian::Little>>(segment, buffer));
+                else
+                    segments.push_back(std::make_shared<Segment<Elf64_Phdr, endian::Big>>(segment, buffer));
+            } else {
+                auto segment = (const Elf32_Phdr *) (
+                        buffer +
+                        header->segmentOffset() +
+                        i * header->segmentEntrySize()
+                );
+
+                if (header->ident()[EI_DATA] == ELFDATA2LSB)
+                    segments.push_back(std::make_shared<Segment<Elf32_Phdr, endian::Little>>(segment, buffer));
+                else
+                    segments.push_back(std::make_shared<Segment<Elf32_Phdr, endian::Big>>(segment, buffer));
+            }
         }
-    }
+    });
+
+    return mContext->segments;
+}
+
+const std::vector<std::shared_ptr<elf::ISection>> &elf::Reader::sections() const {
+    std::call_once(mContext->sectionsOnce, [this]() {
+        auto header = this->header();
+        size_t num = header->sectionNum();
+
+        auto &sections = mContext->sections;
+        sections.reserve(num);
+
+        size_t index = header->sectionStrIndex();
+
+        // names are resolved before the handles are published, nothing writes to them afterwards
+        const char *strings = index < num ? (const char *) sectionAt(*header, index, nullptr)->data() : nullptr;
+
+        for (size_t i = 0; i < num; i++)
+            sections.push_back(sectionAt(*header, i, strings));
+    });
+
+    return mContext->sections;
+}
+
+std::shared_ptr<elf::ISection> elf::Reader::section(size_t index) const {
+    const auto &sections = this->sections();
+
+    if (index >= sections.size())
+        return nullptr;
+
+    return sections[index];
+}
+
+std::shared_ptr<elf::ISection> elf::Reader::section(std::string_view name) const {
+    const auto &sections = this->sections();
+
+    // the first section wins when names repeat, as with a linear search
+    std::call_once(mContext->namesOnce, [&]() {
+        for (size_t i = 0; i < sections.size(); i++)
+            mContext->names.try_emplace(sections[i]->name(), i);
+    });
 
-    for (const auto &section: sections)
-        section->name((char *) sections[header->sectionStrIndex()]->data() + section->nameIndex());
+    auto it = mContext->names.find(name);
 
-    return sections;
+    if (it == mContext->names.end())
+        return nullptr;
+
+    return sections[it->second];
+}
+
+std::shared_ptr<elf::ISection> elf::Reader::sectionAt(IHeader &header, size_t index, const char *strings) const {
+    auto buffer = (const std::byte *) mBuffer.get();
+    auto section = buffer + header.sectionOffset() + index * header.sectionEntrySize();
+
+    if (header.ident()[EI_CLASS] == ELFCLASS64) {
+        if (header.ident()[EI_DATA] == ELFDATA2LSB)
+            return std::make_shared<Section<Elf64_Shdr, endian::Little>>((const Elf64_Shdr *) section, buffer, strings);
+        else
+            return std::make_shared<Section<Elf64_Shdr, endian::Big>>((const Elf64_Shdr *) section, buffer, strings);
+    } else {
+        if (header.ident()[EI_DATA] == ELFDATA2LSB)
+            return std::make_shared<Section<Elf32_Shdr, endian::Little>>((const Elf32_Shdr *) section, buffer, strings);
+        else
+            return std::make_shared<Section<Elf32_Shdr, endian::Big>>((const Elf32_Shdr *) section, buffer, strings);
+    }
 }
 
 const std::byte *elf::Reader::virtualMemory(Elf64_Addr address) const {
-    auto segments = this->segments();
+    const auto &segments = this->segments();
 
     auto it = std::find_if(
             segments.begin(),
@@ -117,7 +162,7 @@ const std::byte *elf::Reader::virtualMemory(Elf64_Addr address) const {
 }
 
 std::optional<std::vector<std::byte>> elf::Reader::readVirtualMemory(Elf64_Addr address, Elf64_Xword length) const {
-    auto segments = this->segments();
+    const auto &segments = this->segments();
 
     auto it = std::find_if(
             segments.begin(),
@@ -144,57 +189,17 @@ std::optional<std::vector<std::byte>> elf::Reader::readVirtualMemory(Elf64_Addr
 }
 
 tl::expected<elf::Reader, std::error_code> elf::openFile(const std::filesystem::path &path) {
-    std::error_code ec;
-    size_t length = std::filesystem::file_size(path, ec);
-
-    if (ec != std::errc())
-        return tl::unexpected(ec);
-
-    if (length < EI_NIDENT)
-        return tl::unexpected(Error::INVALID_ELF_HEADER);
-
-    int fd = open(path.string().c_str(), O_RDONLY);
+    auto mapping = mapFile(path);
 
-    if (fd < 0)
-        return tl::unexpected(std::error_code(errno, std::system_category()));
+    if (!mapping)
+        return tl::unexpected(mapping.error());
 
-    void *buffer = mmap(
-            nullptr,
-            length,
-            PROT_READ,
-            MAP_PRIVATE,
-            fd,
-            0
-    );
-
-    if (buffer == MAP_FAILED) {
-        close(fd);
-        return tl::unexpected(std::error_code(errno, std::system_category()));
-    }
-
-    close(fd);
-
-    auto ident = (unsigned char *) buffer;
-
-    if (ident[EI_MAG0] != ELFMAG0 ||
-        ident[EI_MAG1] != ELFMAG1 ||
-        ident[EI_MAG2] != ELFMAG2 ||
-        ident[EI_MAG3] != ELFMAG3) {
-        munmap(buffer, length);
-        return tl::unexpected(Error::INVALID_ELF_MAGIC);
-    }
-
-    if (ident[EI_CLASS] != ELFCLASS64 && ident[EI_CLASS] != ELFCLASS32) {
-        munmap(buffer, length);
-        return tl::unexpected(Error::INVALID_ELF_CLASS);
-    }
+    return openMemory(std::move(mapping->buffer), mapping->length);
+}
 
-    if (ident[EI_DATA] != ELFDATA2LSB && ident[EI_DATA] != ELFDATA2MSB) {
-        munmap(buffer, length);
-        return tl::unexpected(Error::INVALID_ELF_ENDIAN);
-    }
+tl::expected<elf::Reader, std::error_code> elf::openMemory(std::shared_ptr<void> buffer, size_t length) {
+    if (auto ec = checkIdent((const std::byte *) buffer.get(), length))
+        return tl::unexpected(ec);
 
-    return Reader(std::shared_ptr<void>(buffer, [=](void *ptr) {
-        munmap(ptr, length);
-    }));
+    return Reader(std::move(buffer), length);
 }
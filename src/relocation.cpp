@@ -1,8 +1,177 @@
 #include <elf/relocation.h>
+#include "cursor.h"
+#include <algorithm>
+#include <cstring>
+
+#ifndef SHT_RELR
+#define SHT_RELR 19
+#endif
+
+namespace {
+    enum Calculation {
+        NONE,
+        RELATIVE,
+        ABSOLUTE,
+        SLOT,
+        UNSUPPORTED
+    };
+}
 
 template<typename T, elf::endian::Type Endian>
-elf::Relocation<T, Endian>::Relocation(const T *relocation) : mRelocation(relocation) {
+static elf::RelocationView view(const std::byte *entry, const elf::SymbolViews &symbols) {
+    elf::Relocation<T, Endian> relocation((const T *) entry);
+    Elf64_Xword index = relocation.symbolIndex();
+
+    std::optional<elf::SymbolView> symbol;
+
+    if (index < (Elf64_Xword) (symbols.end() - symbols.begin()))
+        symbol = *(symbols.begin() + (std::ptrdiff_t) index);
+
+    return {
+            relocation.offset(),
+            relocation.info(),
+            relocation.addend(),
+            relocation.type(),
+            index,
+            symbol
+    };
+}
+
+static Elf64_Xword relativeType(Elf64_Half machine) {
+    switch (machine) {
+        case EM_X86_64:
+            return R_X86_64_RELATIVE;
+
+        case EM_386:
+            return R_386_RELATIVE;
+
+        case EM_AARCH64:
+            return R_AARCH64_RELATIVE;
+
+        case EM_ARM:
+            return R_ARM_RELATIVE;
+
+        case EM_RISCV:
+            return R_RISCV_RELATIVE;
+
+        case EM_PPC64:
+            return R_PPC64_RELATIVE;
+
+        default:
+            return 0;
+    }
+}
+
+// how a word sized slot is computed, anything beyond plain data relocations is left to the caller
+static Calculation calculation(Elf64_Half machine, Elf64_Xword type) {
+    if (!type)
+        return NONE;
+
+    if (type == relativeType(machine))
+        return RELATIVE;
+
+    switch (machine) {
+        case EM_X86_64:
+            if (type == R_X86_64_64)
+                return ABSOLUTE;
+
+            if (type == R_X86_64_GLOB_DAT || type == R_X86_64_JUMP_SLOT)
+                return SLOT;
+
+            break;
+
+        case EM_386:
+            if (type == R_386_32)
+                return ABSOLUTE;
+
+            if (type == R_386_GLOB_DAT || type == R_386_JMP_SLOT)
+                return SLOT;
+
+            break;
+
+        case EM_AARCH64:
+            if (type == R_AARCH64_ABS64)
+                return ABSOLUTE;
+
+            if (type == R_AARCH64_GLOB_DAT || type == R_AARCH64_JUMP_SLOT)
+                return SLOT;
+
+            break;
+
+        case EM_ARM:
+            if (type == R_ARM_ABS32)
+                return ABSOLUTE;
+
+            if (type == R_ARM_GLOB_DAT || type == R_ARM_JUMP_SLOT)
+                return SLOT;
+
+            break;
+
+        case EM_RISCV:
+            if (type == R_RISCV_64)
+                return ABSOLUTE;
+
+            if (type == R_RISCV_JUMP_SLOT)
+                return SLOT;
+
+            break;
+
+        case EM_PPC64:
+            if (type == R_PPC64_ADDR64)
+                return ABSOLUTE;
+
+            if (type == R_PPC64_GLOB_DAT || type == R_PPC64_JMP_SLOT)
+                return SLOT;
+
+            break;
+
+        default:
+            break;
+    }
+
+    return UNSUPPORTED;
+}
 
+// an even word relocates the address it holds, an odd one is a bitmap over the words that follow
+static void relr(
+        const std::byte *data,
+        Elf64_Xword size,
+        bool wide,
+        elf::endian::Type endian,
+        Elf64_Xword type,
+        size_t section,
+        std::vector<elf::RelocationEntry> &entries
+) {
+    elf::Cursor cursor(data, size, endian);
+
+    Elf64_Xword word = wide ? sizeof(Elf64_Xword) : sizeof(Elf32_Word);
+    Elf64_Addr where = 0;
+
+    auto add = [&](Elf64_Addr offset) {
+        entries.push_back({{offset, type, 0, type, 0, std::nullopt}, SHT_RELR, section});
+    };
+
+    while (cursor.remaining() >= word) {
+        Elf64_Xword entry = wide ? cursor.read<Elf64_Xword>() : cursor.read<Elf32_Word>();
+
+        if (!(entry & 1)) {
+            add(entry);
+            where = entry + word;
+            continue;
+        }
+
+        for (Elf64_Xword i = 1; i < word * 8; i++) {
+            if ((entry >> i) & 1)
+                add(where + (i - 1) * word);
+        }
+
+        where += (word * 8 - 1) * word;
+    }
+}
+
+template<typename T, elf::endian::Type Endian>
+elf::Relocation<T, Endian>::Relocation(const T *relocation) : mRelocation() {
+    std::memcpy(&mRelocation, relocation, sizeof(T));
 }
 
 template<typename T, elf::endian::Type Endian>
@@ -17,12 +186,12 @@ void elf::Relocation<T, Endian>::symbol(std::shared_ptr<ISymbol> symbol) {
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Addr elf::Relocation<T, Endian>::offset() {
-    return endian::convert<Endian>(mRelocation->r_offset);
+    return endian::convert<Endian>(mRelocation.r_offset);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Xword elf::Relocation<T, Endian>::info() {
-    return endian::convert<Endian>(mRelocation->r_info);
+    return endian::convert<Endian>(mRelocation.r_info);
 }
 
 template<typename T, elf::endian::Type Endian>
@@ -30,7 +199,7 @@ Elf64_Sxword elf::Relocation<T, Endian>::addend() {
     if constexpr (std::is_same_v<T, Elf32_Rel> || std::is_same_v<T, Elf64_Rel>) {
         return 0;
     } else {
-        return endian::convert<Endian>(mRelocation->r_addend);
+        return endian::convert<Endian>(mRelocation.r_addend);
     }
 }
 
@@ -57,8 +226,8 @@ elf::RelocationIterator::RelocationIterator(
         size_t size,
         endian::Type endian,
         bool addend,
-        elf::SymbolTable symbolTable
-) : mRelocation(relocation), mSize(size), mEndian(endian), mAddend(addend), mSymbolTable(std::move(symbolTable)) {
+        elf::SymbolTable *symbolTable
+) : mRelocation(relocation), mSize(size), mEndian(endian), mAddend(addend), mSymbolTable(symbolTable) {
 
 }
 
@@ -91,7 +260,8 @@ std::unique_ptr<elf::IRelocation> elf::RelocationIterator::operator*() {
         }
     }
 
-    relocation->symbol(mSymbolTable[relocation->symbolIndex()]);
+    if (relocation->symbolIndex() < mSymbolTable->size())
+        relocation->symbol(mSymbolTable->operator[](relocation->symbolIndex()));
 
     return relocation;
 }
@@ -114,8 +284,95 @@ bool elf::RelocationIterator::operator!=(const elf::RelocationIterator &rhs) {
     return !operator==(rhs);
 }
 
-elf::RelocationTable::RelocationTable(elf::Reader reader, std::shared_ptr<ISection> section) : mReader(
-        std::move(reader)), mSection(std::move(section)) {
+elf::RelocationViewIterator::RelocationViewIterator(
+        const std::byte *relocation,
+        size_t size,
+        endian::Type endian,
+        bool addend,
+        SymbolViews symbols
+) : mRelocation(relocation), mSize(size), mEndian(endian), mAddend(addend), mSymbols(symbols) {
+
+}
+
+elf::RelocationView elf::RelocationViewIterator::operator*() const {
+    if (mAddend) {
+        if (mSize == sizeof(Elf64_Rela)) {
+            if (mEndian == endian::Little)
+                return view<Elf64_Rela, endian::Little>(mRelocation, mSymbols);
+            else
+                return view<Elf64_Rela, endian::Big>(mRelocation, mSymbols);
+        } else {
+            if (mEndian == endian::Little)
+                return view<Elf32_Rela, endian::Little>(mRelocation, mSymbols);
+            else
+                return view<Elf32_Rela, endian::Big>(mRelocation, mSymbols);
+        }
+    } else {
+        if (mSize == sizeof(Elf64_Rel)) {
+            if (mEndian == endian::Little)
+                return view<Elf64_Rel, endian::Little>(mRelocation, mSymbols);
+            else
+                return view<Elf64_Rel, endian::Big>(mRelocation, mSymbols);
+        } else {
+            if (mEndian == endian::Little)
+                return view<Elf32_Rel, endian::Little>(mRelocation, mSymbols);
+            else
+                return view<Elf32_Rel, endian::Big>(mRelocation, mSymbols);
+        }
+    }
+}
+
+elf::RelocationViewIterator &elf::RelocationViewIterator::operator--() {
+    return operator+=(-1);
+}
+
+elf::RelocationViewIterator &elf::RelocationViewIterator::operator++() {
+    return operator+=(1);
+}
+
+elf::RelocationViewIterator &elf::RelocationViewIterator::operator+=(std::ptrdiff_t offset) {
+    mRelocation += offset * (std::ptrdiff_t) mSize;
+    return *this;
+}
+
+elf::RelocationViewIterator elf::RelocationViewIterator::operator-(std::ptrdiff_t offset) const {
+    return operator+(-offset);
+}
+
+elf::RelocationViewIterator elf::RelocationViewIterator::operator+(std::ptrdiff_t offset) const {
+    RelocationViewIterator it = *this;
+    it += offset;
+    return it;
+}
+
+bool elf::RelocationViewIterator::operator==(const elf::RelocationViewIterator &rhs) const {
+    return mRelocation == rhs.mRelocation;
+}
+
+bool elf::RelocationViewIterator::operator!=(const elf::RelocationViewIterator &rhs) const {
+    return !operator==(rhs);
+}
+
+std::ptrdiff_t elf::RelocationViewIterator::operator-(const elf::RelocationViewIterator &rhs) const {
+    return (mRelocation - rhs.mRelocation) / (std::ptrdiff_t) mSize;
+}
+
+elf::RelocationViews::RelocationViews(elf::RelocationViewIterator begin, elf::RelocationViewIterator end)
+        : mBegin(begin), mEnd(end) {
+
+}
+
+elf::RelocationViewIterator elf::RelocationViews::begin() const {
+    return mBegin;
+}
+
+elf::RelocationViewIterator elf::RelocationViews::end() const {
+    return mEnd;
+}
+
+elf::RelocationTable::RelocationTable(elf::Reader reader, std::shared_ptr<ISection> section)
+        : mReader(std::move(reader)), mSection(std::move(section)),
+          mSymbolTable(mReader, mReader.section(mSection->link())) {
 
 }
 
@@ -133,7 +390,7 @@ elf::RelocationIterator elf::RelocationTable::begin() {
             mSection->entrySize(),
             mReader.header()->ident()[EI_DATA] == ELFDATA2LSB ? endian::Little : endian::Big,
             mSection->type() == SHT_RELA,
-            SymbolTable{mReader, mReader.sections()[mSection->link()]}
+            &mSymbolTable
     };
 }
 
@@ -141,6 +398,160 @@ elf::RelocationIterator elf::RelocationTable::end() {
     return begin() + size();
 }
 
+elf::RelocationView elf::RelocationTable::view(size_t index) {
+    return *(views().begin() + (std::ptrdiff_t) index);
+}
+
+elf::RelocationViews elf::RelocationTable::views() {
+    RelocationViewIterator begin = {
+            mSection->data(),
+            mSection->entrySize(),
+            mReader.header()->ident()[EI_DATA] == ELFDATA2LSB ? endian::Little : endian::Big,
+            mSection->type() == SHT_RELA,
+            mSymbolTable.views()
+    };
+
+    return {begin, begin + (std::ptrdiff_t) size()};
+}
+
+elf::RelocationIndex::RelocationIndex(Reader reader) : mReader(std::move(reader)) {
+    auto header = mReader.header();
+
+    bool wide = header->ident()[EI_CLASS] == ELFCLASS64;
+    auto endian = header->ident()[EI_DATA] == ELFDATA2LSB ? endian::Little : endian::Big;
+
+    const auto &sections = mReader.sections();
+
+    for (size_t i = 0; i < sections.size(); i++) {
+        const auto &section = sections[i];
+
+        // relocations of relocatable objects are section relative and never applied at load time
+        if (!(section->flags() & SHF_ALLOC) || section->type() == SHT_NOBITS)
+            continue;
+
+        if (section->type() == SHT_RELR) {
+            relr(section->data(), section->size(), wide, endian, relativeType(header->machine()), i, mEntries);
+            continue;
+        }
+
+        if (section->type() != SHT_REL && section->type() != SHT_RELA)
+            continue;
+
+        if (!section->entrySize() || !mReader.section(section->link()))
+            continue;
+
+        for (const auto &relocation: RelocationTable(mReader, section).views())
+            mEntries.push_back({relocation, section->type(), i});
+    }
+
+    std::stable_sort(
+            mEntries.begin(),
+            mEntries.end(),
+            [](const auto &lhs, const auto &rhs) {
+                return lhs.relocation.offset < rhs.relocation.offset;
+            }
+    );
+}
+
+size_t elf::RelocationIndex::size() const {
+    return mEntries.size();
+}
+
+const std::vector<elf::RelocationEntry> &elf::RelocationIndex::entries() const {
+    return mEntries;
+}
+
+const elf::RelocationEntry *elf::RelocationIndex::find(Elf64_Addr offset) const {
+    auto [begin, end] = range(offset, offset + 1);
+
+    if (begin == end)
+        return nullptr;
+
+    return begin;
+}
+
+std::pair<const elf::RelocationEntry *, const elf::RelocationEntry *>
+elf::RelocationIndex::range(Elf64_Addr begin, Elf64_Addr end) const {
+    auto compare = [](const auto &entry, Elf64_Addr offset) {
+        return entry.relocation.offset < offset;
+    };
+
+    auto first = std::lower_bound(mEntries.begin(), mEntries.end(), begin, compare);
+    auto last = std::lower_bound(first, mEntries.end(), std::max(begin, end), compare);
+
+    return {mEntries.data() + (first - mEntries.begin()), mEntries.data() + (last - mEntries.begin())};
+}
+
+std::optional<Elf64_Addr> elf::RelocationIndex::read(Elf64_Addr address, Elf64_Addr base) const {
+    auto header = mReader.header();
+
+    bool wide = header->ident()[EI_CLASS] == ELFCLASS64;
+    Elf64_Xword width = wide ? sizeof(Elf64_Xword) : sizeof(Elf32_Word);
+
+    // slots in zero filled memory read as zero
+    auto bytes = mReader.readVirtualMemory(address, width);
+    Elf64_Xword raw = 0;
+
+    if (bytes) {
+        Cursor cursor(bytes->data(), width, header->ident()[EI_DATA] == ELFDATA2LSB ? endian::Little : endian::Big);
+        raw = wide ? cursor.read<Elf64_Xword>() : cursor.read<Elf32_Word>();
+    }
+
+    auto entry = find(address);
+
+    if (!entry)
+        return bytes ? std::optional<Elf64_Addr>(raw) : std::nullopt;
+
+    const auto &relocation = entry->relocation;
+    bool explicitAddend = entry->sectionType == SHT_RELA;
+
+    // relr entries carry the machine's relative type, without one they would read as none and keep the raw slot
+    if (entry->sectionType == SHT_RELR && !relativeType(header->machine()))
+        return std::nullopt;
+
+    // rel and relr keep the addend in the slot itself
+    Elf64_Addr addend = explicitAddend ? relocation.addend : raw;
+    std::optional<Elf64_Addr> symbol;
+
+    if (!relocation.symbolIndex) {
+        symbol = 0;
+    } else if (relocation.symbol && relocation.symbol->sectionIndex != SHN_UNDEF &&
+               ELF64_ST_TYPE(relocation.symbol->info) != STT_GNU_IFUNC) {
+        symbol = relocation.symbol->value + (relocation.symbol->sectionIndex == SHN_ABS ? 0 : base);
+    }
+
+    Elf64_Addr value;
+
+    switch (calculation(header->machine(), relocation.type)) {
+        case NONE:
+            value = raw;
+            break;
+
+        case RELATIVE:
+            value = base + addend;
+            break;
+
+        case ABSOLUTE:
+            if (!symbol)
+                return std::nullopt;
+
+            value = *symbol + addend;
+            break;
+
+        case SLOT:
+            if (!symbol)
+                return std::nullopt;
+
+            value = *symbol + (explicitAddend ? addend : 0);
+            break;
+
+        default:
+            return std::nullopt;
+    }
+
+    return wide ? value : value & 0xffffffff;
+}
+
 template
 class elf::Relocation<Elf32_Rel, elf::endian::Little>;
 
@@ -0,0 +1,192 @@
+#include <elf/scanner.h>
+#include <elf/symbol.h>
+#include <elf/dynamic.h>
+#include <atomic>
+#include <algorithm>
+
+const std::vector<elf::Library> &elf::SymbolIndex::libraries() const {
+    return mLibraries;
+}
+
+std::vector<const elf::Library *> elf::SymbolIndex::find(const std::string &symbol) const {
+    auto it = mSymbols.find(symbol);
+
+    if (it == mSymbols.end())
+        return {};
+
+    std::vector<const Library *> libraries;
+
+    std::transform(
+            it->second.begin(),
+            it->second.end(),
+            std::back_inserter(libraries),
+            [this](size_t index) {
+                return &mLibraries[index];
+            }
+    );
+
+    return libraries;
+}
+
+void elf::SymbolIndex::insert(elf::Library library) {
+    size_t index = mLibraries.size();
+
+    // versioned duplicates such as memcpy@GLIBC_2.2.5 and memcpy@@GLIBC_2.14 list the library once
+    for (const auto &symbol: library.symbols) {
+        auto &libraries = mSymbols[symbol];
+
+        if (libraries.empty() || libraries.back() != index)
+            libraries.push_back(index);
+    }
+
+    mLibraries.push_back(std::move(library));
+}
+
+elf::Scanner::Scanner(size_t concurrency) : mConcurrency(std::max<size_t>(concurrency, 1)) {
+
+}
+
+elf::SymbolIndex elf::Scanner::scan(const std::vector<std::filesystem::path> &roots) {
+    std::vector<std::filesystem::path> paths;
+
+    for (const auto &root: roots) {
+        std::error_code ec;
+
+        for (std::filesystem::recursive_directory_iterator it(
+                root,
+                std::filesystem::directory_options::skip_permission_denied,
+                ec
+        ), end; !ec && it != end; it.increment(ec)) {
+            if (it->is_symlink(ec) || !it->is_regular_file(ec))
+                continue;
+
+            paths.push_back(it->path());
+        }
+    }
+
+    std::atomic<size_t> next = 0;
+    std::vector<std::vector<Library>> results(std::min(mConcurrency, std::max<size_t>(paths.size(), 1)));
+    std::vector<std::thread> threads;
+
+    for (auto &result: results) {
+        threads.emplace_back([&]() {
+            while (true) {
+                size_t index = next++;
+
+                if (index >= paths.size())
+                    break;
+
+                auto library = inspect(paths[index]);
+
+                if (!library)
+                    continue;
+
+                result.push_back(std::move(*library));
+            }
+        });
+    }
+
+    for (auto &thread: threads)
+        thread.join();
+
+    SymbolIndex index;
+
+    for (auto &result: results) {
+        for (auto &library: result)
+            index.insert(std::move(library));
+    }
+
+    return index;
+}
+
+std::optional<elf::Library> elf::inspect(const std::filesystem::path &path) {
+    auto reader = openFile(path);
+
+    if (!reader)
+        return std::nullopt;
+
+    // skip truncated files whose section header table lies outside the mapping
+    size_t length = reader->length();
+    auto header = reader->header();
+
+    if (header->sectionOffset() + header->sectionEntrySize() > length ||
+        header->sectionOffset() + (Elf64_Xword) header->sectionNum() * header->sectionEntrySize() > length ||
+        (header->sectionNum() && header->sectionStrIndex() >= header->sectionNum()))
+        return std::nullopt;
+
+    const auto &sections = reader->sections();
+    bool wide = header->ident()[EI_CLASS] == ELFCLASS64;
+
+    // a forged offset or size must not send the tables past the mapping
+    auto inside = [&](const std::shared_ptr<ISection> &section) {
+        return section &&
+               section->type() != SHT_NOBITS &&
+               section->offset() <= length &&
+               section->size() <= length - section->offset();
+    };
+
+    auto usable = [&](const std::shared_ptr<ISection> &section, size_t entrySize) {
+        return inside(section) && section->entrySize() == entrySize && inside(reader->section(section->link()));
+    };
+
+    auto dynamic = std::find_if(
+            sections.begin(),
+            sections.end(),
+            [&](const auto &section) {
+                return section->type() == SHT_DYNAMIC && usable(section, wide ? sizeof(Elf64_Dyn) : sizeof(Elf32_Dyn));
+            }
+    );
+
+    auto dynamicSymbol = std::find_if(
+            sections.begin(),
+            sections.end(),
+            [&](const auto &section) {
+                return section->type() == SHT_DYNSYM && usable(section, wide ? sizeof(Elf64_Sym) : sizeof(Elf32_Sym));
+            }
+    );
+
+    if (dynamic == sections.end() && dynamicSymbol == sections.end())
+        return std::nullopt;
+
+    Library library = {};
+    library.path = path;
+
+    if (dynamic != sections.end()) {
+        DynamicTable table(*reader, *dynamic);
+
+        for (const auto &entry: table) {
+            if (entry->tag() == DT_NULL)
+                break;
+
+            if (entry->tag() == DT_SONAME)
+                library.soname = table.string(entry->value());
+            else if (entry->tag() == DT_NEEDED)
+                library.needed.push_back(table.string(entry->value()));
+        }
+    }
+
+    if (dynamicSymbol != sections.end()) {
+        // views bound every name by the string table
+        for (const auto &symbol: SymbolTable(*reader, *dynamicSymbol).views()) {
+            if (symbol.sectionIndex == SHN_UNDEF || symbol.name.empty())
+                continue;
+
+            unsigned char bind = ELF64_ST_BIND(symbol.info);
+            unsigned char type = ELF64_ST_TYPE(symbol.info);
+            unsigned char visibility = ELF64_ST_VISIBILITY(symbol.other);
+
+            if (bind != STB_GLOBAL && bind != STB_WEAK && bind != STB_GNU_UNIQUE)
+                continue;
+
+            if (type == STT_SECTION || type == STT_FILE)
+                continue;
+
+            if (visibility != STV_DEFAULT && visibility != STV_PROTECTED)
+                continue;
+
+            library.symbols.emplace_back(symbol.name);
+        }
+    }
+
+    return library;
+}
@@ -0,0 +1,165 @@
+#include <elf/search.h>
+#include <algorithm>
+#include <cstring>
+#include <fnmatch.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// compares the first and last needle byte sixteen positions at a time, only candidates reach memcmp
+static const char *find(const char *begin, const char *end, std::string_view needle) {
+    size_t size = needle.size();
+
+    if ((size_t) (end - begin) < size)
+        return nullptr;
+
+    if (size == 1)
+        return (const char *) memchr(begin, needle[0], end - begin);
+
+    const char *p = begin;
+
+#ifdef __SSE2__
+    __m128i first = _mm_set1_epi8(needle.front());
+    __m128i last = _mm_set1_epi8(needle.back());
+
+    for (; end - p >= (std::ptrdiff_t) (size - 1 + 16); p += 16) {
+        __m128i head = _mm_loadu_si128((const __m128i *) p);
+        __m128i tail = _mm_loadu_si128((const __m128i *) (p + size - 1));
+
+        auto mask = (unsigned) _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(head, first), _mm_cmpeq_epi8(tail, last)));
+
+        while (mask) {
+            int bit = __builtin_ctz(mask);
+
+            if (memcmp(p + bit + 1, needle.data() + 1, size - 2) == 0)
+                return p + bit;
+
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    auto position = std::string_view(p, end - p).find(needle);
+
+    if (position == std::string_view::npos)
+        return nullptr;
+
+    return p + position;
+}
+
+// the longest run of plain characters, which every match must contain
+static std::string_view literal(std::string_view pattern) {
+    std::string_view longest;
+    size_t start = 0;
+
+    for (size_t i = 0; i <= pattern.size(); i++) {
+        if (i < pattern.size() && !strchr("*?[\\", pattern[i]))
+            continue;
+
+        if (i - start > longest.size())
+            longest = pattern.substr(start, i - start);
+
+        // bracket expressions and escapes are left to fnmatch
+        if (i < pattern.size() && pattern[i] == '[') {
+            auto close = pattern.find(']', i + 2);
+            i = close == std::string_view::npos ? pattern.size() : close;
+        } else if (i < pattern.size() && pattern[i] == '\\') {
+            i++;
+        }
+
+        start = i + 1;
+    }
+
+    return longest;
+}
+
+elf::SymbolSearch::SymbolSearch(SymbolTable table) : mTable(std::move(table)) {
+    auto strings = mTable.strings();
+
+    if (!strings || strings->type() == SHT_NOBITS)
+        return;
+
+    mStrings = {(const char *) strings->data(), strings->size()};
+
+    size_t index = 0;
+
+    for (const auto &symbol: mTable.views()) {
+        if (!symbol.name.empty())
+            mIndex.emplace_back(symbol.nameIndex, index);
+
+        index++;
+    }
+
+    std::sort(mIndex.begin(), mIndex.end());
+}
+
+std::vector<size_t> elf::SymbolSearch::contains(std::string_view literal) {
+    return scan(literal, [=](std::string_view name) {
+        return name.find(literal) != std::string_view::npos;
+    });
+}
+
+std::vector<size_t> elf::SymbolSearch::prefix(std::string_view literal) {
+    return scan(literal, [=](std::string_view name) {
+        return name.substr(0, literal.size()) == literal;
+    });
+}
+
+std::vector<size_t> elf::SymbolSearch::glob(std::string_view pattern) {
+    std::string expression(pattern);
+
+    return scan(::literal(pattern), [&](std::string_view name) {
+        // names end at a terminator unless the table itself is cut short
+        if (name.data() + name.size() < mStrings.data() + mStrings.size())
+            return fnmatch(expression.c_str(), name.data(), 0) == 0;
+
+        return fnmatch(expression.c_str(), std::string(name).c_str(), 0) == 0;
+    });
+}
+
+std::vector<size_t> elf::SymbolSearch::match(const std::regex &regex, std::string_view literal) {
+    return scan(literal, [&](std::string_view name) {
+        return std::regex_search(name.begin(), name.end(), regex);
+    });
+}
+
+template<typename F>
+std::vector<size_t> elf::SymbolSearch::scan(std::string_view literal, F &&f) {
+    std::vector<size_t> result;
+
+    const char *begin = mStrings.data();
+    const char *end = begin + mStrings.size();
+
+    for (const char *cursor = begin; cursor < end;) {
+        const char *hit = literal.empty() ? cursor : find(cursor, end, literal);
+
+        if (!hit)
+            break;
+
+        // merged tails let names start anywhere inside the string holding the hit
+        auto terminator = (const char *) memrchr(cursor, 0, hit - cursor);
+        const char *start = terminator ? terminator + 1 : cursor;
+
+        auto next = (const char *) memchr(hit, 0, end - hit);
+        const char *stop = next ? next : end;
+
+        auto it = std::lower_bound(
+                mIndex.begin(),
+                mIndex.end(),
+                std::pair<Elf64_Word, size_t>(start - begin, 0)
+        );
+
+        for (; it != mIndex.end() && it->first < (size_t) (stop - begin); it++) {
+            if (f(std::string_view(begin + it->first, stop - begin - it->first)))
+                result.push_back(it->second);
+        }
+
+        cursor = stop + 1;
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+
+    return result;
+}
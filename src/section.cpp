@@ -1,10 +1,14 @@
 #include <elf/section.h>
 #include <elf/endian.h>
+#include <cstring>
 
 template<typename T, elf::endian::Type Endian>
-elf::Section<T, Endian>::Section(const T *section, std::shared_ptr<void> buffer)
-        : mSection(section), mBuffer(std::move(buffer)) {
+elf::Section<T, Endian>::Section(const T *section, const std::byte *buffer, const char *strings)
+        : mSection(), mBuffer(buffer) {
+    std::memcpy(&mSection, section, sizeof(T));
 
+    if (strings)
+        mName = strings + nameIndex();
 }
 
 template<typename T, elf::endian::Type Endian>
@@ -12,64 +16,59 @@ std::string elf::Section<T, Endian>::name() {
     return mName;
 }
 
-template<typename T, elf::endian::Type Endian>
-void elf::Section<T, Endian>::name(std::string_view name) {
-    mName = name;
-}
-
 template<typename T, elf::endian::Type Endian>
 const std::byte *elf::Section<T, Endian>::data() {
-    return (const std::byte *) mBuffer.get() + offset();
+    return mBuffer + offset();
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Word elf::Section<T, Endian>::nameIndex() {
-    return endian::convert<Endian>(mSection->sh_name);
+    return endian::convert<Endian>(mSection.sh_name);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Word elf::Section<T, Endian>::type() {
-    return endian::convert<Endian>(mSection->sh_type);
+    return endian::convert<Endian>(mSection.sh_type);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Xword elf::Section<T, Endian>::flags() {
-    return endian::convert<Endian>(mSection->sh_flags);
+    return endian::convert<Endian>(mSection.sh_flags);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Addr elf::Section<T, Endian>::address() {
-    return endian::convert<Endian>(mSection->sh_addr);
+    return endian::convert<Endian>(mSection.sh_addr);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Off elf::Section<T, Endian>::offset() {
-    return endian::convert<Endian>(mSection->sh_offset);
+    return endian::convert<Endian>(mSection.sh_offset);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Xword elf::Section<T, Endian>::size() {
-    return endian::convert<Endian>(mSection->sh_size);
+    return endian::convert<Endian>(mSection.sh_size);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Word elf::Section<T, Endian>::link() {
-    return endian::convert<Endian>(mSection->sh_link);
+    return endian::convert<Endian>(mSection.sh_link);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Word elf::Section<T, Endian>::info() {
-    return endian::convert<Endian>(mSection->sh_info);
+    return endian::convert<Endian>(mSection.sh_info);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Xword elf::Section<T, Endian>::addressAlign() {
-    return endian::convert<Endian>(mSection->sh_addralign);
+    return endian::convert<Endian>(mSection.sh_addralign);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Xword elf::Section<T, Endian>::entrySize() {
-    return endian::convert<Endian>(mSection->sh_entsize);
+    return endian::convert<Endian>(mSection.sh_entsize);
 }
 
 template
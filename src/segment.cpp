@@ -1,54 +1,55 @@
 #include <elf/segment.h>
+#include <cstring>
 
 template<typename T, elf::endian::Type Endian>
-elf::Segment<T, Endian>::Segment(const T *segment, std::shared_ptr<void> buffer)
-        : mSegment(segment), mBuffer(std::move(buffer)) {
-
+elf::Segment<T, Endian>::Segment(const T *segment, const std::byte *buffer)
+        : mSegment(), mBuffer(buffer) {
+    std::memcpy(&mSegment, segment, sizeof(T));
 }
 
 template<typename T, elf::endian::Type Endian>
 const std::byte *elf::Segment<T, Endian>::data() {
-    return (const std::byte *) mBuffer.get() + offset();
+    return mBuffer + offset();
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Word elf::Segment<T, Endian>::type() {
-    return endian::convert<Endian>(mSegment->p_type);
+    return endian::convert<Endian>(mSegment.p_type);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Word elf::Segment<T, Endian>::flags() {
-    return endian::convert<Endian>(mSegment->p_flags);
+    return endian::convert<Endian>(mSegment.p_flags);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Off elf::Segment<T, Endian>::offset() {
-    return endian::convert<Endian>(mSegment->p_offset);
+    return endian::convert<Endian>(mSegment.p_offset);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Addr elf::Segment<T, Endian>::virtualAddress() {
-    return endian::convert<Endian>(mSegment->p_vaddr);
+    return endian::convert<Endian>(mSegment.p_vaddr);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Addr elf::Segment<T, Endian>::physicalAddress() {
-    return endian::convert<Endian>(mSegment->p_paddr);
+    return endian::convert<Endian>(mSegment.p_paddr);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Xword elf::Segment<T, Endian>::fileSize() {
-    return endian::convert<Endian>(mSegment->p_filesz);
+    return endian::convert<Endian>(mSegment.p_filesz);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Xword elf::Segment<T, Endian>::memorySize() {
-    return endian::convert<Endian>(mSegment->p_memsz);
+    return endian::convert<Endian>(mSegment.p_memsz);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Xword elf::Segment<T, Endian>::align() {
-    return endian::convert<Endian>(mSegment->p_align);
+    return endian::convert<Endian>(mSegment.p_align);
 }
 
 template
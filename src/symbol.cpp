@@ -1,103 +1,130 @@
 #include <elf/symbol.h>
+#include <cstring>
 
 template<typename T, elf::endian::Type Endian>
-elf::Symbol<T, Endian>::Symbol(const T *symbol) : mSymbol(symbol) {
+static elf::SymbolView view(const std::byte *entry, const std::byte *extended, const char *strings, Elf64_Xword length) {
+    elf::Symbol<T, Endian> symbol((const T *) entry, (const Elf32_Word *) extended);
+    Elf64_Word index = symbol.nameIndex();
 
+    std::string_view name;
+
+    if (index && index < length)
+        name = {strings + index, strnlen(strings + index, length - index)};
+
+    return {
+            name,
+            index,
+            symbol.info(),
+            symbol.other(),
+            symbol.sectionIndex(),
+            symbol.value(),
+            symbol.size()
+    };
 }
 
 template<typename T, elf::endian::Type Endian>
-std::string elf::Symbol<T, Endian>::name() {
-    return mName;
+elf::Symbol<T, Endian>::Symbol(const T *symbol, const Elf32_Word *extended, const char *strings)
+        : mSymbol(), mExtended(extended) {
+    std::memcpy(&mSymbol, symbol, sizeof(T));
+
+    if (strings && nameIndex())
+        mName = strings + nameIndex();
 }
 
 template<typename T, elf::endian::Type Endian>
-void elf::Symbol<T, Endian>::name(std::string_view name) {
-    mName = name;
+std::string elf::Symbol<T, Endian>::name() {
+    return mName;
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Word elf::Symbol<T, Endian>::nameIndex() {
-    return endian::convert<Endian>(mSymbol->st_name);
+    return endian::convert<Endian>(mSymbol.st_name);
 }
 
 template<typename T, elf::endian::Type Endian>
 unsigned char elf::Symbol<T, Endian>::info() {
-    return mSymbol->st_info;
+    return mSymbol.st_info;
 }
 
 template<typename T, elf::endian::Type Endian>
 unsigned char elf::Symbol<T, Endian>::other() {
-    return mSymbol->st_other;
+    return mSymbol.st_other;
 }
 
 template<typename T, elf::endian::Type Endian>
-Elf64_Section elf::Symbol<T, Endian>::sectionIndex() {
-    return endian::convert<Endian>(mSymbol->st_shndx);
+Elf64_Word elf::Symbol<T, Endian>::sectionIndex() {
+    Elf64_Section index = endian::convert<Endian>(mSymbol.st_shndx);
+
+    if (index != SHN_XINDEX || !mExtended)
+        return index;
+
+    Elf32_Word extended;
+    std::memcpy(&extended, mExtended, sizeof(extended));
+
+    return endian::convert<Endian>(extended);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Addr elf::Symbol<T, Endian>::value() {
-    return endian::convert<Endian>(mSymbol->st_value);
+    return endian::convert<Endian>(mSymbol.st_value);
 }
 
 template<typename T, elf::endian::Type Endian>
 Elf64_Xword elf::Symbol<T, Endian>::size() {
-    return endian::convert<Endian>(mSymbol->st_size);
+    return endian::convert<Endian>(mSymbol.st_size);
 }
 
 elf::SymbolIterator::SymbolIterator(
         const std::byte *symbol,
+        const std::byte *extended,
         size_t size,
         endian::Type endian,
-        std::shared_ptr<ISection> section
-) : mSymbol(symbol), mSize(size), mEndian(endian), mSection(std::move(section)) {
+        const char *strings
+) : mSymbol(symbol), mExtended(extended), mSize(size), mEndian(endian), mStrings(strings) {
 
 }
 
 std::unique_ptr<elf::ISymbol> elf::SymbolIterator::operator*() {
-    std::unique_ptr<elf::ISymbol> symbol;
+    auto extended = (const Elf32_Word *) mExtended;
 
     if (mSize == sizeof(Elf64_Sym)) {
         if (mEndian == endian::Little)
-            symbol = std::make_unique<Symbol<Elf64_Sym, endian::Little>>((const Elf64_Sym *) mSymbol);
+            return std::make_unique<Symbol<Elf64_Sym, endian::Little>>((const Elf64_Sym *) mSymbol, extended, mStrings);
         else
-            symbol = std::make_unique<Symbol<Elf64_Sym, endian::Big>>((const Elf64_Sym *) mSymbol);
+            return std::make_unique<Symbol<Elf64_Sym, endian::Big>>((const Elf64_Sym *) mSymbol, extended, mStrings);
     } else {
         if (mEndian == endian::Little)
-            symbol = std::make_unique<Symbol<Elf32_Sym, endian::Little>>((const Elf32_Sym *) mSymbol);
+            return std::make_unique<Symbol<Elf32_Sym, endian::Little>>((const Elf32_Sym *) mSymbol, extended, mStrings);
         else
-            symbol = std::make_unique<Symbol<Elf32_Sym, endian::Big>>((const Elf32_Sym *) mSymbol);
+            return std::make_unique<Symbol<Elf32_Sym, endian::Big>>((const Elf32_Sym *) mSymbol, extended, mStrings);
     }
-
-    if (!symbol->nameIndex())
-        return symbol;
-
-    symbol->name((char *) mSection->data() + symbol->nameIndex());
-
-    return symbol;
 }
 
 elf::SymbolIterator &elf::SymbolIterator::operator--() {
-    mSymbol -= mSize;
-    return *this;
+    return operator+=(-1);
 }
 
 elf::SymbolIterator &elf::SymbolIterator::operator++() {
-    mSymbol += mSize;
-    return *this;
+    return operator+=(1);
 }
 
 elf::SymbolIterator &elf::SymbolIterator::operator+=(std::ptrdiff_t offset) {
-    mSymbol += offset * mSize;
+    mSymbol += offset * (std::ptrdiff_t) mSize;
+
+    if (mExtended)
+        mExtended += offset * (std::ptrdiff_t) sizeof(Elf32_Word);
+
     return *this;
 }
 
 elf::SymbolIterator elf::SymbolIterator::operator-(std::ptrdiff_t offset) {
-    return {mSymbol - offset * mSize, mSize, mEndian, mSection};
+    return operator+(-offset);
 }
 
 elf::SymbolIterator elf::SymbolIterator::operator+(std::ptrdiff_t offset) {
-    return {mSymbol + offset * mSize, mSize, mEndian, mSection};
+    SymbolIterator it = *this;
+    it += offset;
+    return it;
 }
 
 bool elf::SymbolIterator::operator==(const elf::SymbolIterator &rhs) {
@@ -109,28 +136,145 @@ bool elf::SymbolIterator::operator!=(const elf::SymbolIterator &rhs) {
 }
 
 std::ptrdiff_t elf::SymbolIterator::operator-(const elf::SymbolIterator &rhs) {
+    // empty tables have no entry size
+    if (!mSize)
+        return 0;
+
     return (mSymbol - rhs.mSymbol) / (std::ptrdiff_t) mSize;
 }
 
+elf::SymbolViewIterator::SymbolViewIterator(
+        const std::byte *symbol,
+        const std::byte *extended,
+        size_t size,
+        endian::Type endian,
+        const char *strings,
+        Elf64_Xword length
+) : mSymbol(symbol), mExtended(extended), mSize(size), mEndian(endian), mStrings(strings), mLength(length) {
+
+}
+
+elf::SymbolView elf::SymbolViewIterator::operator*() const {
+    if (mSize == sizeof(Elf64_Sym)) {
+        if (mEndian == endian::Little)
+            return view<Elf64_Sym, endian::Little>(mSymbol, mExtended, mStrings, mLength);
+        else
+            return view<Elf64_Sym, endian::Big>(mSymbol, mExtended, mStrings, mLength);
+    } else {
+        if (mEndian == endian::Little)
+            return view<Elf32_Sym, endian::Little>(mSymbol, mExtended, mStrings, mLength);
+        else
+            return view<Elf32_Sym, endian::Big>(mSymbol, mExtended, mStrings, mLength);
+    }
+}
+
+elf::SymbolViewIterator &elf::SymbolViewIterator::operator--() {
+    return operator+=(-1);
+}
+
+elf::SymbolViewIterator &elf::SymbolViewIterator::operator++() {
+    return operator+=(1);
+}
+
+elf::SymbolViewIterator &elf::SymbolViewIterator::operator+=(std::ptrdiff_t offset) {
+    mSymbol += offset * (std::ptrdiff_t) mSize;
+
+    if (mExtended)
+        mExtended += offset * (std::ptrdiff_t) sizeof(Elf32_Word);
+
+    return *this;
+}
+
+elf::SymbolViewIterator elf::SymbolViewIterator::operator-(std::ptrdiff_t offset) const {
+    return operator+(-offset);
+}
+
+elf::SymbolViewIterator elf::SymbolViewIterator::operator+(std::ptrdiff_t offset) const {
+    SymbolViewIterator it = *this;
+    it += offset;
+    return it;
+}
+
+bool elf::SymbolViewIterator::operator==(const elf::SymbolViewIterator &rhs) const {
+    return mSymbol == rhs.mSymbol;
+}
+
+bool elf::SymbolViewIterator::operator!=(const elf::SymbolViewIterator &rhs) const {
+    return !operator==(rhs);
+}
+
+std::ptrdiff_t elf::SymbolViewIterator::operator-(const elf::SymbolViewIterator &rhs) const {
+    // empty tables have no entry size
+    if (!mSize)
+        return 0;
+
+    return (mSymbol - rhs.mSymbol) / (std::ptrdiff_t) mSize;
+}
+
+elf::SymbolViews::SymbolViews(elf::SymbolViewIterator begin, elf::SymbolViewIterator end)
+        : mBegin(begin), mEnd(end) {
+
+}
+
+elf::SymbolViewIterator elf::SymbolViews::begin() const {
+    return mBegin;
+}
+
+elf::SymbolViewIterator elf::SymbolViews::end() const {
+    return mEnd;
+}
+
 elf::SymbolTable::SymbolTable(elf::Reader reader, std::shared_ptr<ISection> section)
         : mReader(std::move(reader)), mSection(std::move(section)) {
+    auto header = mReader.header();
+
+    mEndian = header->ident()[EI_DATA] == ELFDATA2LSB ? endian::Little : endian::Big;
+
+    // a missing section, such as an out of range sh_link, reads as an empty table
+    if (!mSection)
+        return;
+
+    mStrings = mReader.section(mSection->link());
+
+    // escaped section indices only exist once the section count reaches the reserved range
+    if (header->sectionNum() < SHN_LORESERVE)
+        return;
+
+    for (const auto &candidate: mReader.sections()) {
+        if (candidate->type() != SHT_SYMTAB_SHNDX || candidate->size() / sizeof(Elf32_Word) < size())
+            continue;
+
+        auto symbols = mReader.section(candidate->link());
 
+        if (symbols && symbols->offset() == mSection->offset()) {
+            mIndices = candidate;
+            break;
+        }
+    }
 }
 
 size_t elf::SymbolTable::size() {
+    if (!mSection || !mSection->entrySize())
+        return 0;
+
     return mSection->size() / mSection->entrySize();
 }
 
+std::shared_ptr<elf::ISection> elf::SymbolTable::strings() {
+    return mStrings;
+}
+
 std::unique_ptr<elf::ISymbol> elf::SymbolTable::operator[](size_t index) {
     return *(begin() + (std::ptrdiff_t) index);
 }
 
 elf::SymbolIterator elf::SymbolTable::begin() {
     return {
-            mSection->data(),
-            mSection->entrySize(),
-            mReader.header()->ident()[EI_DATA] == ELFDATA2LSB ? endian::Little : endian::Big,
-            mReader.sections()[mSection->link()]
+            mSection ? mSection->data() : nullptr,
+            mIndices ? mIndices->data() : nullptr,
+            mSection ? mSection->entrySize() : 0,
+            mEndian,
+            mStrings ? (const char *) mStrings->data() : nullptr
     };
 }
 
@@ -138,6 +282,23 @@ elf::SymbolIterator elf::SymbolTable::end() {
     return begin() + (std::ptrdiff_t) size();
 }
 
+elf::SymbolView elf::SymbolTable::view(size_t index) {
+    return *(views().begin() + (std::ptrdiff_t) index);
+}
+
+elf::SymbolViews elf::SymbolTable::views() {
+    SymbolViewIterator begin = {
+            mSection ? mSection->data() : nullptr,
+            mIndices ? mIndices->data() : nullptr,
+            mSection ? mSection->entrySize() : 0,
+            mEndian,
+            mStrings ? (const char *) mStrings->data() : nullptr,
+            mStrings && mStrings->type() != SHT_NOBITS ? mStrings->size() : 0
+    };
+
+    return {begin, begin + (std::ptrdiff_t) size()};
+}
+
 template
 class elf::Symbol<Elf32_Sym, elf::endian::Little>;
 
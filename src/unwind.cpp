@@ -0,0 +1,1155 @@
+#include <elf/unwind.h>
+#include "cursor.h"
+#include "dwarf.h"
+#include <algorithm>
+
+constexpr auto DW_EH_PE_OMIT = 0xff;
+constexpr auto DW_EH_PE_INDIRECT = 0x80;
+constexpr auto DW_EH_PE_DATAREL_SDATA4 = 0x3b;
+
+constexpr auto MAX_EXPRESSION_STEPS = 1024;
+
+// user space pointers on AArch64 fit in 48 bits, pointer authentication codes live above them
+constexpr auto AARCH64_ADDRESS_MASK = (1ull << 48) - 1;
+
+namespace elf {
+    namespace {
+        struct CIE {
+            Elf64_Xword codeAlign;
+            Elf64_Sxword dataAlign;
+            Elf64_Word returnAddress;
+            unsigned char encoding;
+            bool augmentation;
+            bool signal;
+            const std::byte *instructions;
+            size_t length;
+        };
+
+        struct State {
+            elf::Rule cfa;
+            std::array<elf::Rule, elf::MAX_REGISTERS> registers;
+            bool signedReturnAddress;
+        };
+
+        // decodes a DW_EH_PE encoded pointer, address is the virtual address of the cursor's first byte
+        std::optional<Elf64_Addr> pointer(
+                elf::Cursor &cursor,
+                unsigned char encoding,
+                size_t addressSize,
+                Elf64_Addr address,
+                Elf64_Addr dataAddress
+        ) {
+            if (encoding == DW_EH_PE_OMIT)
+                return std::nullopt;
+
+            Elf64_Addr field = address + cursor.offset();
+            Elf64_Addr value;
+
+            switch (encoding & 0x0f) {
+                case 0x00:
+                    value = addressSize == 8 ? cursor.read<Elf64_Xword>() : cursor.read<Elf32_Word>();
+                    break;
+
+                case 0x01:
+                    value = cursor.unsignedLEB128();
+                    break;
+
+                case 0x02:
+                    value = cursor.read<uint16_t>();
+                    break;
+
+                case 0x03:
+                    value = cursor.read<uint32_t>();
+                    break;
+
+                case 0x04:
+                    value = cursor.read<uint64_t>();
+                    break;
+
+                case 0x09:
+                    value = cursor.signedLEB128();
+                    break;
+
+                case 0x0a:
+                    value = (Elf64_Sxword) cursor.read<int16_t>();
+                    break;
+
+                case 0x0b:
+                    value = (Elf64_Sxword) cursor.read<int32_t>();
+                    break;
+
+                case 0x0c:
+                    value = cursor.read<int64_t>();
+                    break;
+
+                default:
+                    return std::nullopt;
+            }
+
+            switch (encoding & 0x70) {
+                case 0x00:
+                    break;
+
+                case 0x10:
+                    value += field;
+                    break;
+
+                case 0x30:
+                    value += dataAddress;
+                    break;
+
+                default:
+                    return std::nullopt;
+            }
+
+            if (cursor.failed())
+                return std::nullopt;
+
+            if (addressSize == 4)
+                value &= 0xffffffff;
+
+            return value;
+        }
+
+        std::optional<CIE> parseCIE(elf::Cursor &cursor, size_t addressSize, Elf64_Addr address) {
+            CIE cie = {};
+
+            unsigned char version = cursor.read<unsigned char>();
+            std::string_view augmentation = cursor.string();
+
+            if (version != 1 && version != 3 && version != 4)
+                return std::nullopt;
+
+            if (augmentation.find("eh") != std::string_view::npos)
+                cursor.skip(addressSize);
+
+            if (version == 4) {
+                cursor.read<unsigned char>();
+                cursor.read<unsigned char>();
+            }
+
+            cie.codeAlign = cursor.unsignedLEB128();
+            cie.dataAlign = cursor.signedLEB128();
+            cie.returnAddress = version == 1 ? cursor.read<unsigned char>() : cursor.unsignedLEB128();
+
+            if (!augmentation.empty() && augmentation[0] == 'z') {
+                cie.augmentation = true;
+                size_t length = cursor.unsignedLEB128();
+                size_t end = cursor.offset() + length;
+
+                for (char c: augmentation.substr(1)) {
+                    if (c == 'R') {
+                        cie.encoding = cursor.read<unsigned char>();
+                    } else if (c == 'L') {
+                        cursor.read<unsigned char>();
+                    } else if (c == 'P') {
+                        auto encoding = cursor.read<unsigned char>();
+                        pointer(cursor, encoding & ~DW_EH_PE_INDIRECT, addressSize, address, 0);
+                    } else if (c == 'S') {
+                        cie.signal = true;
+                    } else {
+                        break;
+                    }
+                }
+
+                cursor.seek(end);
+            }
+
+            if (cursor.failed())
+                return std::nullopt;
+
+            cie.instructions = cursor.current();
+            cie.length = cursor.remaining();
+
+            return cie;
+        }
+
+        bool execute(
+                elf::Cursor cursor,
+                const CIE &cie,
+                Elf64_Half machine,
+                size_t addressSize,
+                Elf64_Addr address,
+                Elf64_Addr &location,
+                State &state,
+                const State &initial,
+                std::vector<elf::UnwindRow> *rows
+        ) {
+            std::vector<State> stack;
+
+            auto advance = [&](Elf64_Addr next) {
+                if (rows && next > location)
+                    rows->push_back({
+                            location,
+                            next,
+                            cie.returnAddress,
+                            cie.signal,
+                            state.signedReturnAddress,
+                            state.cfa,
+                            state.registers
+                    });
+
+                location = next;
+            };
+
+            auto set = [&](Elf64_Xword reg, const elf::Rule &rule) {
+                if (reg < elf::MAX_REGISTERS)
+                    state.registers[reg] = rule;
+            };
+
+            while (cursor.remaining() && !cursor.failed()) {
+                auto opcode = cursor.read<unsigned char>();
+                unsigned char operand = opcode & 0x3f;
+
+                switch (opcode & 0xc0) {
+                    case 0x40:
+                        advance(location + operand * cie.codeAlign);
+                        continue;
+
+                    case 0x80:
+                        set(operand, {RuleType::OFFSET, 0, (Elf64_Sxword) cursor.unsignedLEB128() * cie.dataAlign});
+                        continue;
+
+                    case 0xc0:
+                        set(operand, initial.registers[operand < elf::MAX_REGISTERS ? operand : 0]);
+                        continue;
+
+                    default:
+                        break;
+                }
+
+                switch (opcode) {
+                    case DW_CFA_nop:
+                        break;
+
+                    // DW_CFA_AARCH64_negate_ra_state shares the opcode, SPARC register windows need nothing
+                    case DW_CFA_GNU_window_save:
+                        if (machine == EM_AARCH64)
+                            state.signedReturnAddress = !state.signedReturnAddress;
+
+                        break;
+
+                    case DW_CFA_set_loc: {
+                        auto next = pointer(cursor, cie.encoding, addressSize, address, 0);
+
+                        if (!next)
+                            return false;
+
+                        advance(*next);
+                        break;
+                    }
+
+                    case DW_CFA_advance_loc1:
+                        advance(location + cursor.read<uint8_t>() * cie.codeAlign);
+                        break;
+
+                    case DW_CFA_advance_loc2:
+                        advance(location + cursor.read<uint16_t>() * cie.codeAlign);
+                        break;
+
+                    case DW_CFA_advance_loc4:
+                        advance(location + cursor.read<uint32_t>() * cie.codeAlign);
+                        break;
+
+                    case DW_CFA_offset_extended: {
+                        auto reg = cursor.unsignedLEB128();
+                        set(reg, {RuleType::OFFSET, 0, (Elf64_Sxword) cursor.unsignedLEB128() * cie.dataAlign});
+                        break;
+                    }
+
+                    case DW_CFA_restore_extended: {
+                        auto reg = cursor.unsignedLEB128();
+
+                        if (reg < elf::MAX_REGISTERS)
+                            set(reg, initial.registers[reg]);
+
+                        break;
+                    }
+
+                    case DW_CFA_undefined:
+                        set(cursor.unsignedLEB128(), {RuleType::UNDEFINED});
+                        break;
+
+                    case DW_CFA_same_value:
+                        set(cursor.unsignedLEB128(), {RuleType::SAME_VALUE});
+                        break;
+
+                    case DW_CFA_register: {
+                        auto reg = cursor.unsignedLEB128();
+                        set(reg, {RuleType::REGISTER, (Elf64_Word) cursor.unsignedLEB128()});
+                        break;
+                    }
+
+                    case DW_CFA_remember_state:
+                        stack.push_back(state);
+                        break;
+
+                    case DW_CFA_restore_state:
+                        if (stack.empty())
+                            return false;
+
+                        state = stack.back();
+                        stack.pop_back();
+                        break;
+
+                    case DW_CFA_def_cfa: {
+                        auto reg = (Elf64_Word) cursor.unsignedLEB128();
+                        state.cfa = {RuleType::REGISTER, reg, (Elf64_Sxword) cursor.unsignedLEB128()};
+                        break;
+                    }
+
+                    case DW_CFA_def_cfa_register:
+                        state.cfa.type = RuleType::REGISTER;
+                        state.cfa.reg = cursor.unsignedLEB128();
+                        break;
+
+                    case DW_CFA_def_cfa_offset:
+                        state.cfa.offset = (Elf64_Sxword) cursor.unsignedLEB128();
+                        break;
+
+                    case DW_CFA_def_cfa_expression: {
+                        Elf64_Xword length = cursor.unsignedLEB128();
+                        state.cfa = {RuleType::EXPRESSION, 0, 0, cursor.skip(length), length};
+                        break;
+                    }
+
+                    case DW_CFA_expression:
+                    case DW_CFA_val_expression: {
+                        auto reg = cursor.unsignedLEB128();
+                        Elf64_Xword length = cursor.unsignedLEB128();
+
+                        set(
+                                reg,
+                                {
+                                        opcode == DW_CFA_expression ? RuleType::EXPRESSION : RuleType::VAL_EXPRESSION,
+                                        0,
+                                        0,
+                                        cursor.skip(length),
+                                        length
+                                }
+                        );
+
+                        break;
+                    }
+
+                    case DW_CFA_offset_extended_sf: {
+                        auto reg = cursor.unsignedLEB128();
+                        set(reg, {RuleType::OFFSET, 0, cursor.signedLEB128() * cie.dataAlign});
+                        break;
+                    }
+
+                    case DW_CFA_def_cfa_sf: {
+                        auto reg = (Elf64_Word) cursor.unsignedLEB128();
+                        state.cfa = {RuleType::REGISTER, reg, cursor.signedLEB128() * cie.dataAlign};
+                        break;
+                    }
+
+                    case DW_CFA_def_cfa_offset_sf:
+                        state.cfa.offset = cursor.signedLEB128() * cie.dataAlign;
+                        break;
+
+                    case DW_CFA_val_offset: {
+                        auto reg = cursor.unsignedLEB128();
+                        set(reg, {RuleType::VAL_OFFSET, 0, (Elf64_Sxword) cursor.unsignedLEB128() * cie.dataAlign});
+                        break;
+                    }
+
+                    case DW_CFA_val_offset_sf: {
+                        auto reg = cursor.unsignedLEB128();
+                        set(reg, {RuleType::VAL_OFFSET, 0, cursor.signedLEB128() * cie.dataAlign});
+                        break;
+                    }
+
+                    case DW_CFA_GNU_args_size:
+                        cursor.unsignedLEB128();
+                        break;
+
+                    case DW_CFA_GNU_negative_offset_extended: {
+                        auto reg = cursor.unsignedLEB128();
+                        set(reg, {RuleType::OFFSET, 0, -(Elf64_Sxword) cursor.unsignedLEB128() * cie.dataAlign});
+                        break;
+                    }
+
+                    default:
+                        return false;
+                }
+            }
+
+            return !cursor.failed();
+        }
+
+        std::optional<Elf64_Addr> expression(
+                const elf::Rule &rule,
+                elf::endian::Type endian,
+                size_t addressSize,
+                const elf::Registers &registers,
+                const elf::MemoryReader &read,
+                std::optional<Elf64_Addr> initial
+        ) {
+            elf::Cursor cursor(rule.expression, rule.length, endian);
+            std::vector<Elf64_Addr> stack;
+
+            if (initial)
+                stack.push_back(*initial);
+
+            auto reg = [&](Elf64_Xword index) -> std::optional<Elf64_Addr> {
+                if (index >= elf::MAX_REGISTERS || !registers.valid[index])
+                    return std::nullopt;
+
+                return registers.values[index];
+            };
+
+            for (size_t steps = 0; cursor.remaining() && steps < MAX_EXPRESSION_STEPS; steps++) {
+                auto opcode = cursor.read<unsigned char>();
+
+                if (opcode >= DW_OP_lit0 && opcode <= DW_OP_lit31) {
+                    stack.push_back(opcode - DW_OP_lit0);
+                    continue;
+                }
+
+                if (opcode >= DW_OP_breg0 && opcode <= DW_OP_breg31) {
+                    auto value = reg(opcode - DW_OP_breg0);
+
+                    if (!value)
+                        return std::nullopt;
+
+                    stack.push_back(*value + cursor.signedLEB128());
+                    continue;
+                }
+
+                switch (opcode) {
+                    case DW_OP_addr:
+                        stack.push_back(addressSize == 8 ? cursor.read<Elf64_Xword>() : cursor.read<Elf32_Word>());
+                        continue;
+
+                    case DW_OP_const1u:
+                        stack.push_back(cursor.read<uint8_t>());
+                        continue;
+
+                    case DW_OP_const1s:
+                        stack.push_back((Elf64_Sxword) cursor.read<int8_t>());
+                        continue;
+
+                    case DW_OP_const2u:
+                        stack.push_back(cursor.read<uint16_t>());
+                        continue;
+
+                    case DW_OP_const2s:
+                        stack.push_back((Elf64_Sxword) cursor.read<int16_t>());
+                        continue;
+
+                    case DW_OP_const4u:
+                        stack.push_back(cursor.read<uint32_t>());
+                        continue;
+
+                    case DW_OP_const4s:
+                        stack.push_back((Elf64_Sxword) cursor.read<int32_t>());
+                        continue;
+
+                    case DW_OP_const8u:
+                    case DW_OP_const8s:
+                        stack.push_back(cursor.read<uint64_t>());
+                        continue;
+
+                    case DW_OP_constu:
+                        stack.push_back(cursor.unsignedLEB128());
+                        continue;
+
+                    case DW_OP_consts:
+                        stack.push_back(cursor.signedLEB128());
+                        continue;
+
+                    case DW_OP_bregx: {
+                        auto value = reg(cursor.unsignedLEB128());
+
+                        if (!value)
+                            return std::nullopt;
+
+                        stack.push_back(*value + cursor.signedLEB128());
+                        continue;
+                    }
+
+                    case DW_OP_nop:
+                        continue;
+
+                    case DW_OP_skip:
+                        cursor.seek(cursor.offset() + cursor.read<int16_t>());
+                        continue;
+
+                    default:
+                        break;
+                }
+
+                if (stack.empty())
+                    return std::nullopt;
+
+                Elf64_Addr top = stack.back();
+
+                switch (opcode) {
+                    case DW_OP_dup:
+                        stack.push_back(top);
+                        continue;
+
+                    case DW_OP_drop:
+                        stack.pop_back();
+                        continue;
+
+                    case DW_OP_deref:
+                    case DW_OP_deref_size: {
+                        size_t size = opcode == DW_OP_deref ? addressSize : cursor.read<uint8_t>();
+                        auto value = read(top);
+
+                        if (!value)
+                            return std::nullopt;
+
+                        stack.back() = size >= 8 ? *value : *value & ((1ull << (size * 8)) - 1);
+                        continue;
+                    }
+
+                    case DW_OP_abs:
+                        stack.back() = (Elf64_Sxword) top < 0 ? -top : top;
+                        continue;
+
+                    case DW_OP_neg:
+                        stack.back() = -top;
+                        continue;
+
+                    case DW_OP_not:
+                        stack.back() = ~top;
+                        continue;
+
+                    case DW_OP_plus_uconst:
+                        stack.back() = top + cursor.unsignedLEB128();
+                        continue;
+
+                    case DW_OP_bra:
+                        stack.pop_back();
+
+                        if (top)
+                            cursor.seek(cursor.offset() + cursor.read<int16_t>());
+                        else
+                            cursor.read<int16_t>();
+
+                        continue;
+
+                    default:
+                        break;
+                }
+
+                if (opcode == DW_OP_pick) {
+                    auto index = cursor.read<uint8_t>();
+
+                    if (index >= stack.size())
+                        return std::nullopt;
+
+                    stack.push_back(stack[stack.size() - 1 - index]);
+                    continue;
+                }
+
+                if (stack.size() < 2)
+                    return std::nullopt;
+
+                Elf64_Addr second = stack[stack.size() - 2];
+
+                switch (opcode) {
+                    case DW_OP_over:
+                        stack.push_back(second);
+                        continue;
+
+                    case DW_OP_swap:
+                        std::swap(stack[stack.size() - 1], stack[stack.size() - 2]);
+                        continue;
+
+                    case DW_OP_rot:
+                        if (stack.size() < 3)
+                            return std::nullopt;
+
+                        std::rotate(stack.end() - 3, stack.end() - 1, stack.end());
+                        continue;
+
+                    default:
+                        break;
+                }
+
+                Elf64_Addr value;
+
+                switch (opcode) {
+                    case DW_OP_and:
+                        value = second & top;
+                        break;
+
+                    case DW_OP_or:
+                        value = second | top;
+                        break;
+
+                    case DW_OP_xor:
+                        value = second ^ top;
+                        break;
+
+                    case DW_OP_plus:
+                        value = second + top;
+                        break;
+
+                    case DW_OP_minus:
+                        value = second - top;
+                        break;
+
+                    case DW_OP_mul:
+                        value = second * top;
+                        break;
+
+                    case DW_OP_div:
+                        if (!top)
+                            return std::nullopt;
+
+                        value = (Elf64_Sxword) second / (Elf64_Sxword) top;
+                        break;
+
+                    case DW_OP_mod:
+                        if (!top)
+                            return std::nullopt;
+
+                        value = second % top;
+                        break;
+
+                    case DW_OP_shl:
+                        value = top >= 64 ? 0 : second << top;
+                        break;
+
+                    case DW_OP_shr:
+                        value = top >= 64 ? 0 : second >> top;
+                        break;
+
+                    case DW_OP_shra:
+                        value = (Elf64_Sxword) second >> std::min<Elf64_Addr>(top, 63);
+                        break;
+
+                    case DW_OP_eq:
+                        value = second == top;
+                        break;
+
+                    case DW_OP_ne:
+                        value = second != top;
+                        break;
+
+                    case DW_OP_ge:
+                        value = (Elf64_Sxword) second >= (Elf64_Sxword) top;
+                        break;
+
+                    case DW_OP_gt:
+                        value = (Elf64_Sxword) second > (Elf64_Sxword) top;
+                        break;
+
+                    case DW_OP_le:
+                        value = (Elf64_Sxword) second <= (Elf64_Sxword) top;
+                        break;
+
+                    case DW_OP_lt:
+                        value = (Elf64_Sxword) second < (Elf64_Sxword) top;
+                        break;
+
+                    default:
+                        return std::nullopt;
+                }
+
+                stack.pop_back();
+                stack.back() = value;
+            }
+
+            if (stack.empty() || cursor.failed())
+                return std::nullopt;
+
+            return stack.back();
+        }
+    }
+}
+
+elf::EHFrame::EHFrame(elf::Reader reader)
+        : mReader(std::move(reader)), mFrame(nullptr), mFrameAddress(0), mFrameSize(0),
+          mTable(nullptr), mTableAddress(0), mTableCount(0) {
+    auto header = mReader.header();
+
+    mMachine = header->machine();
+    mEndian = header->ident()[EI_DATA] == ELFDATA2LSB ? endian::Little : endian::Big;
+    mAddressSize = header->ident()[EI_CLASS] == ELFCLASS64 ? 8 : 4;
+
+    const auto &segments = mReader.segments();
+    const auto &sections = mReader.sections();
+
+    const std::byte *data = nullptr;
+    Elf64_Addr address = 0;
+    Elf64_Xword size = 0;
+
+    auto segment = std::find_if(
+            segments.begin(),
+            segments.end(),
+            [](const auto &segment) {
+                return segment->type() == PT_GNU_EH_FRAME;
+            }
+    );
+
+    if (segment != segments.end()) {
+        data = segment->operator*().data();
+        address = segment->operator*().virtualAddress();
+        size = segment->operator*().fileSize();
+    } else {
+        auto section = std::find_if(
+                sections.begin(),
+                sections.end(),
+                [](const auto &section) {
+                    return section->name() == ".eh_frame_hdr";
+                }
+        );
+
+        if (section != sections.end()) {
+            data = section->operator*().data();
+            address = section->operator*().address();
+            size = section->operator*().size();
+        }
+    }
+
+    if (data) {
+        Cursor cursor(data, size, mEndian);
+
+        auto version = cursor.read<unsigned char>();
+        auto frameEncoding = cursor.read<unsigned char>();
+        auto countEncoding = cursor.read<unsigned char>();
+        auto tableEncoding = cursor.read<unsigned char>();
+
+        auto frame = pointer(cursor, frameEncoding, mAddressSize, address, address);
+        auto count = pointer(cursor, countEncoding, mAddressSize, address, address);
+
+        if (version == 1 && frame) {
+            auto it = std::find_if(
+                    segments.begin(),
+                    segments.end(),
+                    [&](const auto &segment) {
+                        return segment->type() == PT_LOAD &&
+                               *frame >= segment->virtualAddress() &&
+                               *frame < segment->virtualAddress() + segment->fileSize();
+                    }
+            );
+
+            if (it != segments.end()) {
+                mFrameAddress = *frame;
+                mFrame = it->operator*().data() + *frame - it->operator*().virtualAddress();
+                mFrameSize = it->operator*().virtualAddress() + it->operator*().fileSize() - *frame;
+            }
+        }
+
+        if (mFrame && count && tableEncoding == DW_EH_PE_DATAREL_SDATA4 &&
+            *count <= cursor.remaining() / (2 * sizeof(int32_t))) {
+            mTable = cursor.current();
+            mTableAddress = address;
+            mTableCount = *count;
+        } else if (mFrame && count) {
+            for (Elf64_Xword i = 0; i < *count && !cursor.failed(); i++) {
+                auto location = pointer(cursor, tableEncoding, mAddressSize, address, address);
+                auto fde = pointer(cursor, tableEncoding, mAddressSize, address, address);
+
+                if (!location || !fde)
+                    break;
+
+                mEntries.emplace_back(*location, *fde);
+            }
+        }
+    }
+
+    if (mFrame && (mTable || !mEntries.empty()))
+        return;
+
+    // no usable .eh_frame_hdr, index .eh_frame directly
+    auto section = std::find_if(
+            sections.begin(),
+            sections.end(),
+            [](const auto &section) {
+                return section->name() == ".eh_frame" && section->type() != SHT_NOBITS;
+            }
+    );
+
+    if (section == sections.end())
+        return;
+
+    mFrame = section->operator*().data();
+    mFrameAddress = section->operator*().address();
+    mFrameSize = section->operator*().size();
+
+    Cursor cursor(mFrame, mFrameSize, mEndian);
+
+    while (cursor.remaining()) {
+        size_t offset = cursor.offset();
+        Elf64_Xword length = cursor.read<Elf32_Word>();
+
+        if (!length || cursor.failed())
+            break;
+
+        if (length == 0xffffffff)
+            length = cursor.read<Elf64_Xword>();
+
+        size_t end = cursor.offset() + length;
+
+        if (length > cursor.remaining())
+            break;
+
+        if (cursor.read<Elf32_Word>()) {
+            auto fde = entry(mFrameAddress + offset);
+
+            if (fde)
+                mEntries.emplace_back(fde->begin, fde->address);
+        }
+
+        cursor.seek(end);
+    }
+
+    std::sort(mEntries.begin(), mEntries.end());
+}
+
+size_t elf::EHFrame::size() const {
+    return mTable ? mTableCount : mEntries.size();
+}
+
+std::optional<elf::FDE> elf::EHFrame::find(Elf64_Addr address) const {
+    std::optional<Elf64_Addr> fde;
+
+    if (mTable) {
+        Cursor cursor(mTable, mTableCount * 2 * sizeof(int32_t), mEndian);
+
+        auto location = [&](Elf64_Xword index) {
+            cursor.seek(index * 2 * sizeof(int32_t));
+            return mTableAddress + cursor.read<int32_t>();
+        };
+
+        Elf64_Xword low = 0;
+        Elf64_Xword high = mTableCount;
+
+        while (low < high) {
+            Elf64_Xword middle = low + (high - low) / 2;
+
+            if (location(middle) <= address)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+
+        if (!low)
+            return std::nullopt;
+
+        cursor.seek((low - 1) * 2 * sizeof(int32_t) + sizeof(int32_t));
+        fde = mTableAddress + cursor.read<int32_t>();
+    } else {
+        auto it = std::upper_bound(
+                mEntries.begin(),
+                mEntries.end(),
+                address,
+                [](Elf64_Addr address, const auto &entry) {
+                    return address < entry.first;
+                }
+        );
+
+        if (it == mEntries.begin())
+            return std::nullopt;
+
+        fde = std::prev(it)->second;
+    }
+
+    auto result = entry(*fde);
+
+    if (!result || address < result->begin || address >= result->end)
+        return std::nullopt;
+
+    return result;
+}
+
+std::optional<elf::FDE> elf::EHFrame::entry(Elf64_Addr address) const {
+    if (address < mFrameAddress || address - mFrameAddress >= mFrameSize)
+        return std::nullopt;
+
+    Cursor cursor(mFrame, mFrameSize, mEndian);
+    cursor.seek(address - mFrameAddress);
+
+    Elf64_Xword length = cursor.read<Elf32_Word>();
+
+    if (length == 0xffffffff)
+        length = cursor.read<Elf64_Xword>();
+
+    if (!length || length > cursor.remaining())
+        return std::nullopt;
+
+    size_t end = cursor.offset() + length;
+    size_t field = cursor.offset();
+    Elf64_Word pointerOffset = cursor.read<Elf32_Word>();
+
+    if (!pointerOffset || pointerOffset > field)
+        return std::nullopt;
+
+    Cursor cieCursor(mFrame, mFrameSize, mEndian);
+    cieCursor.seek(field - pointerOffset);
+
+    Elf64_Xword cieLength = cieCursor.read<Elf32_Word>();
+
+    if (cieLength == 0xffffffff)
+        cieLength = cieCursor.read<Elf64_Xword>();
+
+    if (!cieLength || cieLength > cieCursor.remaining())
+        return std::nullopt;
+
+    Cursor body(cieCursor.current(), cieLength, mEndian);
+    Elf64_Addr bodyAddress = mFrameAddress + cieCursor.offset();
+
+    if (body.read<Elf32_Word>())
+        return std::nullopt;
+
+    auto cie = parseCIE(body, mAddressSize, bodyAddress);
+
+    if (!cie)
+        return std::nullopt;
+
+    Cursor fdeCursor(mFrame + cursor.offset(), end - cursor.offset(), mEndian);
+    auto begin = pointer(fdeCursor, cie->encoding, mAddressSize, mFrameAddress + cursor.offset(), 0);
+    auto range = pointer(fdeCursor, cie->encoding & 0x0f, mAddressSize, 0, 0);
+
+    if (!begin || !range)
+        return std::nullopt;
+
+    return FDE{*begin, *begin + *range, address};
+}
+
+std::vector<elf::UnwindRow> elf::EHFrame::evaluate(const FDE &fde) const {
+    Cursor cursor(mFrame, mFrameSize, mEndian);
+    cursor.seek(fde.address - mFrameAddress);
+
+    Elf64_Xword length = cursor.read<Elf32_Word>();
+
+    if (length == 0xffffffff)
+        length = cursor.read<Elf64_Xword>();
+
+    size_t field = cursor.offset();
+    Elf64_Word pointerOffset = cursor.read<Elf32_Word>();
+
+    Cursor cieCursor(mFrame, mFrameSize, mEndian);
+    cieCursor.seek(field - pointerOffset);
+
+    Elf64_Xword cieLength = cieCursor.read<Elf32_Word>();
+
+    if (cieLength == 0xffffffff)
+        cieLength = cieCursor.read<Elf64_Xword>();
+
+    Cursor body(cieCursor.current(), cieLength, mEndian);
+    Elf64_Addr bodyAddress = mFrameAddress + cieCursor.offset();
+
+    body.read<Elf32_Word>();
+    auto cie = parseCIE(body, mAddressSize, bodyAddress);
+
+    if (!cie)
+        return {};
+
+    Cursor fdeCursor(mFrame + cursor.offset(), field + length - cursor.offset(), mEndian);
+    Elf64_Addr fdeAddress = mFrameAddress + cursor.offset();
+
+    pointer(fdeCursor, cie->encoding, mAddressSize, fdeAddress, 0);
+    pointer(fdeCursor, cie->encoding & 0x0f, mAddressSize, 0, 0);
+
+    if (cie->augmentation)
+        fdeCursor.skip(fdeCursor.unsignedLEB128());
+
+    State initial = {};
+
+    for (auto &rule: initial.registers)
+        rule.type = RuleType::SAME_VALUE;
+
+    Elf64_Addr location = fde.begin;
+
+    if (!execute(
+            {cie->instructions, cie->length, mEndian},
+            *cie,
+            mMachine,
+            mAddressSize,
+            bodyAddress + (cie->instructions - body.data()),
+            location,
+            initial,
+            initial,
+            nullptr
+    ))
+        return {};
+
+    State state = initial;
+    std::vector<UnwindRow> rows;
+
+    location = fde.begin;
+
+    if (!execute(
+            {fdeCursor.current(), fdeCursor.remaining(), mEndian},
+            *cie,
+            mMachine,
+            mAddressSize,
+            fdeAddress + fdeCursor.offset(),
+            location,
+            state,
+            initial,
+            &rows
+    ))
+        return {};
+
+    if (location < fde.end)
+        rows.push_back({
+                location,
+                fde.end,
+                cie->returnAddress,
+                cie->signal,
+                state.signedReturnAddress,
+                state.cfa,
+                state.registers
+        });
+
+    return rows;
+}
+
+const elf::UnwindRow *elf::EHFrame::row(Elf64_Addr address) {
+    auto lookup = [&](const std::vector<UnwindRow> &rows) -> const UnwindRow * {
+        auto it = std::upper_bound(
+                rows.begin(),
+                rows.end(),
+                address,
+                [](Elf64_Addr address, const auto &row) {
+                    return address < row.begin;
+                }
+        );
+
+        if (it == rows.begin() || address >= std::prev(it)->end)
+            return nullptr;
+
+        return &*std::prev(it);
+    };
+
+    auto evaluated = [](Elf64_Addr address, const Evaluated &entry) {
+        return address < entry.begin;
+    };
+
+    {
+        std::shared_lock<std::shared_mutex> lock(mMutex);
+        auto it = std::upper_bound(mRows.begin(), mRows.end(), address, evaluated);
+
+        if (it != mRows.begin() && address < std::prev(it)->end)
+            return lookup(std::prev(it)->rows);
+    }
+
+    auto fde = find(address);
+
+    if (!fde)
+        return nullptr;
+
+    auto rows = evaluate(*fde);
+
+    std::lock_guard<std::shared_mutex> guard(mMutex);
+    auto it = std::upper_bound(mRows.begin(), mRows.end(), fde->begin, evaluated);
+
+    // another thread may have evaluated the same entry meanwhile
+    if (it != mRows.begin() && std::prev(it)->begin == fde->begin)
+        return lookup(std::prev(it)->rows);
+
+    // moving an entry keeps its rows in place, so rows handed out earlier stay valid
+    return lookup(mRows.insert(it, {fde->begin, fde->end, std::move(rows)})->rows);
+}
+
+bool elf::EHFrame::step(Registers &registers, Elf64_Addr bias, const MemoryReader &read) {
+    Elf64_Word pc;
+    Elf64_Word sp;
+
+    if (mMachine == EM_X86_64) {
+        pc = 16;
+        sp = 7;
+    } else if (mMachine == EM_AARCH64) {
+        pc = 32;
+        sp = 31;
+    } else {
+        return false;
+    }
+
+    if (!registers.valid[pc])
+        return false;
+
+    // return addresses point past the call, look up the call instruction itself
+    auto row = this->row(registers.values[pc] - bias - (registers.caller ? 1 : 0));
+
+    if (!row)
+        return false;
+
+    std::optional<Elf64_Addr> cfa;
+
+    if (row->cfa.type == RuleType::REGISTER) {
+        if (row->cfa.reg < MAX_REGISTERS && registers.valid[row->cfa.reg])
+            cfa = registers.values[row->cfa.reg] + row->cfa.offset;
+    } else if (row->cfa.type == RuleType::EXPRESSION) {
+        cfa = expression(row->cfa, mEndian, mAddressSize, registers, read, std::nullopt);
+    }
+
+    if (!cfa)
+        return false;
+
+    Registers next = registers;
+
+    for (size_t i = 0; i < MAX_REGISTERS; i++) {
+        const Rule &rule = row->registers[i];
+        std::optional<Elf64_Addr> value;
+
+        switch (rule.type) {
+            case RuleType::UNDEFINED:
+                next.valid[i] = false;
+                continue;
+
+            case RuleType::SAME_VALUE:
+                continue;
+
+            case RuleType::OFFSET:
+                value = read(*cfa + rule.offset);
+                break;
+
+            case RuleType::VAL_OFFSET:
+                value = *cfa + rule.offset;
+                break;
+
+            case RuleType::REGISTER:
+                if (rule.reg < MAX_REGISTERS && registers.valid[rule.reg])
+                    value = registers.values[rule.reg];
+
+                break;
+
+            case RuleType::EXPRESSION:
+                value = expression(rule, mEndian, mAddressSize, registers, read, *cfa);
+
+                if (value)
+                    value = read(*value);
+
+                break;
+
+            case RuleType::VAL_EXPRESSION:
+                value = expression(rule, mEndian, mAddressSize, registers, read, *cfa);
+                break;
+        }
+
+        next.valid[i] = value.has_value();
+
+        if (value)
+            next.values[i] = *value;
+    }
+
+    if (row->returnAddress >= MAX_REGISTERS ||
+        row->registers[row->returnAddress].type == RuleType::UNDEFINED ||
+        !next.valid[row->returnAddress])
+        return false;
+
+    next.values[pc] = next.values[row->returnAddress];
+
+    if (mMachine == EM_AARCH64 && row->signedReturnAddress)
+        next.values[pc] &= AARCH64_ADDRESS_MASK;
+    next.valid[pc] = true;
+    next.values[sp] = *cfa;
+    next.valid[sp] = true;
+    next.caller = !row->signal;
+
+    if (!next.values[pc])
+        return false;
+
+    registers = next;
+    return true;
+}
@@ -0,0 +1,264 @@
+#include <elf/watch.h>
+#include <elf/note.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <algorithm>
+
+constexpr auto WATCH_MASK = IN_CLOSE_WRITE | IN_MOVED_TO;
+
+elf::WatchedReader::WatchedReader(Reader reader)
+        : mReader(std::make_shared<const Reader>(std::move(reader))), mGeneration(0), mInode(), mSize(0), mModified() {
+
+}
+
+elf::Reader elf::WatchedReader::reader() const {
+    return *std::atomic_load(&mReader);
+}
+
+size_t elf::WatchedReader::generation() const {
+    return mGeneration;
+}
+
+elf::ReaderWatcher::ReaderWatcher() : mFD(-1), mEvent(-1) {
+
+}
+
+elf::ReaderWatcher::~ReaderWatcher() {
+    if (mThread.joinable()) {
+        eventfd_write(mEvent, 1);
+        mThread.join();
+    }
+
+    if (mFD >= 0)
+        close(mFD);
+
+    if (mEvent >= 0)
+        close(mEvent);
+}
+
+tl::expected<std::shared_ptr<elf::WatchedReader>, std::error_code>
+elf::ReaderWatcher::open(const std::filesystem::path &path) {
+    std::error_code ec;
+    std::filesystem::path absolute = std::filesystem::absolute(path, ec).lexically_normal();
+
+    if (ec)
+        return tl::unexpected(ec);
+
+    std::lock_guard<std::mutex> guard(mMutex);
+    auto it = mFiles.find(absolute.string());
+
+    if (it != mFiles.end())
+        return it->second.second;
+
+    ec = start();
+
+    if (ec)
+        return tl::unexpected(ec);
+
+    // watch before looking at the file, a replacement in between still produces an event
+    int wd = inotify_add_watch(mFD, absolute.parent_path().c_str(), WATCH_MASK);
+
+    if (wd < 0)
+        return tl::unexpected(std::error_code(errno, std::system_category()));
+
+    auto &directory = mDirectories[wd];
+
+    auto release = [&]() {
+        if (!directory.paths.empty())
+            return;
+
+        inotify_rm_watch(mFD, wd);
+        mDirectories.erase(wd);
+    };
+
+    struct stat st = {};
+
+    if (stat(absolute.c_str(), &st) < 0) {
+        ec = std::error_code(errno, std::system_category());
+        release();
+        return tl::unexpected(ec);
+    }
+
+    auto reader = openFile(absolute);
+
+    if (!reader) {
+        release();
+        return tl::unexpected(reader.error());
+    }
+
+    auto entry = std::make_shared<WatchedReader>(std::move(*reader));
+
+    entry->mID = buildID(entry->reader());
+    entry->mInode = {st.st_dev, st.st_ino};
+    entry->mSize = st.st_size;
+    entry->mModified = st.st_mtim;
+
+    directory.paths[absolute.parent_path().string()]++;
+    mFiles.emplace(absolute.string(), std::make_pair(wd, entry));
+
+    return entry;
+}
+
+void elf::ReaderWatcher::unwatch(const std::filesystem::path &path) {
+    std::error_code ec;
+    std::filesystem::path absolute = std::filesystem::absolute(path, ec).lexically_normal();
+
+    if (ec)
+        return;
+
+    std::lock_guard<std::mutex> guard(mMutex);
+    auto it = mFiles.find(absolute.string());
+
+    if (it == mFiles.end())
+        return;
+
+    int wd = it->second.first;
+    mFiles.erase(it);
+
+    auto directory = mDirectories.find(wd);
+
+    if (directory == mDirectories.end())
+        return;
+
+    auto &paths = directory->second.paths;
+    auto parent = paths.find(absolute.parent_path().string());
+
+    if (parent != paths.end() && !--parent->second)
+        paths.erase(parent);
+
+    if (!paths.empty())
+        return;
+
+    inotify_rm_watch(mFD, wd);
+    mDirectories.erase(directory);
+}
+
+std::error_code elf::ReaderWatcher::start() {
+    if (mThread.joinable())
+        return {};
+
+    mFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (mFD < 0)
+        return {errno, std::system_category()};
+
+    mEvent = eventfd(0, EFD_CLOEXEC);
+
+    if (mEvent < 0) {
+        std::error_code ec(errno, std::system_category());
+
+        close(mFD);
+        mFD = -1;
+
+        return ec;
+    }
+
+    mThread = std::thread(&ReaderWatcher::run, this);
+    return {};
+}
+
+void elf::ReaderWatcher::run() {
+    alignas(inotify_event) char buffer[4096];
+    pollfd fds[2] = {{mFD, POLLIN, 0}, {mEvent, POLLIN, 0}};
+
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+
+            break;
+        }
+
+        if (fds[1].revents)
+            break;
+
+        ssize_t length = read(mFD, buffer, sizeof(buffer));
+
+        if (length <= 0)
+            continue;
+
+        std::vector<std::filesystem::path> changed;
+
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+
+            for (ssize_t offset = 0; offset < length;) {
+                auto event = (const inotify_event *) (buffer + offset);
+                offset += (ssize_t) (sizeof(inotify_event) + event->len);
+
+                // events were dropped, any file may have changed and refresh skips those that did not
+                if (event->mask & IN_Q_OVERFLOW) {
+                    for (const auto &file: mFiles)
+                        changed.emplace_back(file.first);
+
+                    continue;
+                }
+
+                auto directory = mDirectories.find(event->wd);
+
+                if (!event->len || directory == mDirectories.end())
+                    continue;
+
+                for (const auto &parent: directory->second.paths) {
+                    auto path = std::filesystem::path(parent.first) / event->name;
+
+                    if (mFiles.find(path.string()) != mFiles.end())
+                        changed.push_back(std::move(path));
+                }
+            }
+        }
+
+        std::sort(changed.begin(), changed.end());
+        changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+        for (const auto &path: changed)
+            refresh(path);
+    }
+}
+
+void elf::ReaderWatcher::refresh(const std::filesystem::path &path) {
+    std::shared_ptr<WatchedReader> entry;
+
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        auto it = mFiles.find(path.string());
+
+        if (it == mFiles.end())
+            return;
+
+        entry = it->second.second;
+    }
+
+    struct stat st = {};
+
+    if (stat(path.c_str(), &st) < 0)
+        return;
+
+    if (entry->mInode == std::make_pair(st.st_dev, st.st_ino) &&
+        entry->mSize == st.st_size &&
+        entry->mModified.tv_sec == st.st_mtim.tv_sec &&
+        entry->mModified.tv_nsec == st.st_mtim.tv_nsec)
+        return;
+
+    // a half written file fails to open and is picked up again on its next event
+    auto reader = openFile(path);
+
+    if (!reader)
+        return;
+
+    auto id = buildID(*reader);
+
+    entry->mInode = {st.st_dev, st.st_ino};
+    entry->mSize = st.st_size;
+    entry->mModified = st.st_mtim;
+
+    // same build, the old reader and every index built on it stay valid
+    if (id && id == entry->mID)
+        return;
+
+    entry->mID = std::move(id);
+    std::atomic_store(&entry->mReader, std::make_shared<const Reader>(std::move(*reader)));
+    entry->mGeneration++;
+}
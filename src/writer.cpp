@@ -0,0 +1,573 @@
+#include <elf/writer.h>
+#include <elf/dynamic.h>
+#include <elf/error.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+constexpr auto COPY_BUFFER_SIZE = 1024 * 1024;
+
+template<elf::endian::Type Endian, typename T>
+static Elf64_Xword load(T field) {
+    return elf::endian::convert<Endian>(field);
+}
+
+template<elf::endian::Type Endian, typename T>
+static void store(T &field, Elf64_Xword value) {
+    field = elf::endian::convert<Endian>((T) value);
+}
+
+template<typename T>
+static std::vector<std::byte> bytes(const T &value) {
+    std::vector<std::byte> data(sizeof(T));
+    memcpy(data.data(), &value, sizeof(T));
+    return data;
+}
+
+template<typename T, elf::endian::Type Endian>
+static std::vector<std::byte> dynamicEntry(Elf64_Sxword tag, Elf64_Xword value) {
+    T dynamic = {};
+
+    store<Endian>(dynamic.d_tag, tag);
+    store<Endian>(dynamic.d_un.d_val, value);
+
+    return bytes(dynamic);
+}
+
+static std::error_code writeAll(int fd, const std::byte *data, size_t length, Elf64_Off offset) {
+    while (length) {
+        ssize_t n = pwrite(fd, data, length, (off_t) offset);
+
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+
+            return {errno, std::system_category()};
+        }
+
+        data += n;
+        offset += n;
+        length -= n;
+    }
+
+    return {};
+}
+
+// stays in the kernel where it can, copy_file_range may even share extents on reflink file systems
+static std::error_code copy(int in, int out, Elf64_Off offset, Elf64_Xword length) {
+    while (length) {
+        loff_t from = (loff_t) offset;
+        loff_t to = (loff_t) offset;
+        ssize_t n = copy_file_range(in, &from, out, &to, length, 0);
+
+        if (n > 0) {
+            offset += n;
+            length -= n;
+            continue;
+        }
+
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n == 0 || (errno != EXDEV && errno != ENOSYS && errno != EINVAL && errno != EOPNOTSUPP))
+            return n == 0 ? std::make_error_code(std::errc::io_error) : std::error_code(errno, std::system_category());
+
+        break;
+    }
+
+    while (length) {
+        if (lseek(out, (off_t) offset, SEEK_SET) < 0)
+            return {errno, std::system_category()};
+
+        off_t from = (off_t) offset;
+        ssize_t n = sendfile(out, in, &from, length);
+
+        if (n > 0) {
+            offset += n;
+            length -= n;
+            continue;
+        }
+
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n == 0 || (errno != EINVAL && errno != ENOSYS))
+            return n == 0 ? std::make_error_code(std::errc::io_error) : std::error_code(errno, std::system_category());
+
+        break;
+    }
+
+    std::unique_ptr<std::byte[]> buffer;
+
+    if (length)
+        buffer = std::make_unique<std::byte[]>(COPY_BUFFER_SIZE);
+
+    while (length) {
+        ssize_t n = pread(in, buffer.get(), std::min<Elf64_Xword>(length, COPY_BUFFER_SIZE), (off_t) offset);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n <= 0)
+            return n == 0 ? std::make_error_code(std::errc::io_error) : std::error_code(errno, std::system_category());
+
+        auto ec = writeAll(out, buffer.get(), n, offset);
+
+        if (ec)
+            return ec;
+
+        offset += n;
+        length -= n;
+    }
+
+    return {};
+}
+
+elf::Writer::Writer(Reader reader, std::filesystem::path path) : mReader(std::move(reader)), mPath(std::move(path)) {
+
+}
+
+const elf::Reader &elf::Writer::reader() const {
+    return mReader;
+}
+
+std::error_code elf::Writer::replace(size_t index, std::vector<std::byte> data) {
+    auto section = mReader.section(index);
+
+    if (!index || !section || section->type() == SHT_NOBITS)
+        return std::make_error_code(std::errc::invalid_argument);
+
+    // pending dynamic entries would be written over the new contents
+    if (section->type() == SHT_DYNAMIC && !mDynamicTags.empty())
+        return std::make_error_code(std::errc::invalid_argument);
+
+    // mapped sections cannot move without relinking
+    if ((section->flags() & SHF_ALLOC) && data.size() > section->size())
+        return Error::SECTION_OVERFLOW;
+
+    mReplacements.insert_or_assign(index, std::move(data));
+    return {};
+}
+
+std::error_code elf::Writer::replace(std::string_view name, std::vector<std::byte> data) {
+    const auto &sections = mReader.sections();
+
+    for (size_t i = 1; i < sections.size(); i++) {
+        if (sections[i]->name() == name)
+            return replace(i, std::move(data));
+    }
+
+    return std::make_error_code(std::errc::invalid_argument);
+}
+
+std::error_code elf::Writer::addSection(
+        std::string name,
+        Elf64_Word type,
+        std::vector<std::byte> data,
+        Elf64_Xword addressAlign,
+        Elf64_Xword flags
+) {
+    // nothing maps a new section, so it cannot claim to be loaded
+    if ((flags & SHF_ALLOC) || type == SHT_NOBITS || type == SHT_NULL)
+        return std::make_error_code(std::errc::invalid_argument);
+
+    mAdditions.push_back({std::move(name), type, flags, std::max<Elf64_Xword>(addressAlign, 1), std::move(data)});
+    return {};
+}
+
+std::error_code elf::Writer::addNote(
+        std::string section,
+        std::string_view owner,
+        Elf64_Word type,
+        const std::vector<std::byte> &descriptor
+) {
+    bool little = mReader.header()->ident()[EI_DATA] == ELFDATA2LSB;
+    std::vector<std::byte> data;
+
+    auto word = [&](Elf32_Word value) {
+        value = little ? endian::convert<endian::Little>(value) : endian::convert<endian::Big>(value);
+        data.insert(data.end(), (const std::byte *) &value, (const std::byte *) &value + sizeof(value));
+    };
+
+    auto pad = [&]() {
+        data.resize((data.size() + 3) & ~size_t(3));
+    };
+
+    word(owner.size() + 1);
+    word(descriptor.size());
+    word(type);
+
+    data.insert(data.end(), (const std::byte *) owner.data(), (const std::byte *) owner.data() + owner.size());
+    data.push_back(std::byte{0});
+    pad();
+
+    data.insert(data.end(), descriptor.begin(), descriptor.end());
+    pad();
+
+    return addSection(std::move(section), SHT_NOTE, std::move(data), 4, 0);
+}
+
+std::error_code elf::Writer::dynamic(Elf64_Sxword tag, Elf64_Xword value) {
+    const auto &sections = mReader.sections();
+
+    auto it = std::find_if(
+            sections.begin(),
+            sections.end(),
+            [](const auto &section) {
+                return section->type() == SHT_DYNAMIC;
+            }
+    );
+
+    if (it == sections.end() || !(*it)->entrySize())
+        return std::make_error_code(std::errc::invalid_argument);
+
+    // a replaced table is written whole, patches into the original layout would corrupt it
+    if (mReplacements.count(it - sections.begin()))
+        return std::make_error_code(std::errc::invalid_argument);
+
+    DynamicTable table(mReader, *it);
+    std::optional<size_t> slot;
+
+    // earlier calls already claimed spare slots, they count as written
+    auto tagAt = [&](size_t index) {
+        auto pending = mDynamicTags.find(index);
+        return pending != mDynamicTags.end() ? pending->second : table[index]->tag();
+    };
+
+    for (size_t i = 0; i < table.size(); i++) {
+        Elf64_Sxword current = tagAt(i);
+
+        if (current == tag) {
+            slot = i;
+            break;
+        }
+
+        // linkers leave spare null entries behind the terminator, a new tag takes the first and keeps the rest
+        if (current == DT_NULL) {
+            if (i + 1 < table.size() && tagAt(i + 1) == DT_NULL)
+                slot = i;
+
+            break;
+        }
+    }
+
+    if (!slot)
+        return Error::SECTION_OVERFLOW;
+
+    auto ident = mReader.header()->ident();
+    std::vector<std::byte> entry;
+
+    if (ident[EI_CLASS] == ELFCLASS64) {
+        if (ident[EI_DATA] == ELFDATA2LSB)
+            entry = dynamicEntry<Elf64_Dyn, endian::Little>(tag, value);
+        else
+            entry = dynamicEntry<Elf64_Dyn, endian::Big>(tag, value);
+    } else {
+        if (ident[EI_DATA] == ELFDATA2LSB)
+            entry = dynamicEntry<Elf32_Dyn, endian::Little>(tag, value);
+        else
+            entry = dynamicEntry<Elf32_Dyn, endian::Big>(tag, value);
+    }
+
+    Elf64_Off offset = (*it)->offset() + *slot * (*it)->entrySize();
+
+    auto patch = std::find_if(
+            mPatches.begin(),
+            mPatches.end(),
+            [=](const auto &patch) {
+                return patch.first == offset;
+            }
+    );
+
+    if (patch != mPatches.end())
+        patch->second = std::move(entry);
+    else
+        mPatches.emplace_back(offset, std::move(entry));
+
+    mDynamicTags[*slot] = tag;
+    return {};
+}
+
+void elf::Writer::entry(Elf64_Addr address) {
+    mEntry = address;
+}
+
+std::error_code elf::Writer::write(const std::filesystem::path &path) const {
+    std::error_code ec;
+
+    // truncating the source would destroy the ranges still to be copied
+    if (std::filesystem::equivalent(path, mPath, ec))
+        return update();
+
+    auto plan = this->plan();
+
+    if (!plan)
+        return plan.error();
+
+    struct stat st = {};
+    int in = open(mPath.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (in < 0)
+        return {errno, std::system_category()};
+
+    if (fstat(in, &st) < 0) {
+        ec = std::error_code(errno, std::system_category());
+        close(in);
+        return ec;
+    }
+
+    int out = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & 07777);
+
+    if (out < 0) {
+        ec = std::error_code(errno, std::system_category());
+        close(in);
+        return ec;
+    }
+
+    std::vector<std::pair<Elf64_Off, Elf64_Off>> written;
+
+    for (const auto &[offset, data]: plan->writes)
+        written.emplace_back(offset, offset + data.size());
+
+    std::sort(written.begin(), written.end());
+
+    // only the bytes no edit overwrites come from the original
+    Elf64_Off cursor = 0;
+    Elf64_Off length = st.st_size;
+
+    for (const auto &[begin, end]: written) {
+        if (begin > cursor && !ec)
+            ec = copy(in, out, cursor, std::min(begin, length) - std::min(cursor, length));
+
+        cursor = std::max(cursor, end);
+    }
+
+    if (cursor < length && !ec)
+        ec = copy(in, out, cursor, length - cursor);
+
+    for (const auto &[offset, data]: plan->writes) {
+        if (ec)
+            break;
+
+        ec = writeAll(out, data.data(), data.size(), offset);
+    }
+
+    if (!ec && ftruncate(out, (off_t) std::max(plan->size, length)) < 0)
+        ec = std::error_code(errno, std::system_category());
+
+    close(in);
+    close(out);
+
+    return ec;
+}
+
+std::error_code elf::Writer::update() const {
+    auto plan = this->plan();
+
+    if (!plan)
+        return plan.error();
+
+    int fd = open(mPath.c_str(), O_WRONLY | O_CLOEXEC);
+
+    if (fd < 0)
+        return {errno, std::system_category()};
+
+    std::error_code ec;
+
+    // the elf header is planned last, so it only points at new ranges once they exist
+    for (const auto &[offset, data]: plan->writes) {
+        ec = writeAll(fd, data.data(), data.size(), offset);
+
+        if (ec)
+            break;
+    }
+
+    close(fd);
+    return ec;
+}
+
+tl::expected<elf::Writer::Plan, std::error_code> elf::Writer::plan() const {
+    std::error_code ec;
+    size_t length = std::filesystem::file_size(mPath, ec);
+
+    if (ec)
+        return tl::unexpected(ec);
+
+    auto ident = mReader.header()->ident();
+
+    if (ident[EI_CLASS] == ELFCLASS64) {
+        if (ident[EI_DATA] == ELFDATA2LSB)
+            return plan<Elf64_Ehdr, Elf64_Shdr, endian::Little>(length);
+        else
+            return plan<Elf64_Ehdr, Elf64_Shdr, endian::Big>(length);
+    } else {
+        if (ident[EI_DATA] == ELFDATA2LSB)
+            return plan<Elf32_Ehdr, Elf32_Shdr, endian::Little>(length);
+        else
+            return plan<Elf32_Ehdr, Elf32_Shdr, endian::Big>(length);
+    }
+}
+
+template<typename Ehdr, typename Shdr, elf::endian::Type Endian>
+tl::expected<elf::Writer::Plan, std::error_code> elf::Writer::plan(Elf64_Off length) const {
+    auto buffer = (const std::byte *) mReader.buffer().get();
+    auto header = mReader.header();
+
+    Elf64_Off tableOffset = header->sectionOffset();
+    size_t count = header->sectionNum();
+
+    if (count && (header->sectionEntrySize() != sizeof(Shdr) ||
+                  tableOffset > length || count > (length - tableOffset) / sizeof(Shdr)))
+        return tl::unexpected(make_error_code(Error::INVALID_ELF_HEADER));
+
+    Ehdr ehdr;
+    std::vector<Shdr> shdrs(count);
+
+    memcpy(&ehdr, buffer, sizeof(Ehdr));
+    memcpy(shdrs.data(), buffer + tableOffset, count * sizeof(Shdr));
+
+    Plan plan;
+    Elf64_Off end = length;
+    bool tableChanged = false;
+    bool headerChanged = false;
+
+    auto append = [&](std::vector<std::byte> data, Elf64_Xword align) {
+        end = (end + align - 1) / align * align;
+
+        Elf64_Off offset = end;
+        end += data.size();
+
+        plan.writes.emplace_back(offset, std::move(data));
+        return offset;
+    };
+
+    for (const auto &[index, contents]: mReplacements) {
+        if (index >= count)
+            return tl::unexpected(make_error_code(std::errc::invalid_argument));
+
+        auto &shdr = shdrs[index];
+        Elf64_Off offset = load<Endian>(shdr.sh_offset);
+        Elf64_Xword size = load<Endian>(shdr.sh_size);
+
+        if (offset > length || size > length - offset)
+            return tl::unexpected(make_error_code(Error::INVALID_ELF_HEADER));
+
+        std::vector<std::byte> data = contents;
+
+        if (load<Endian>(shdr.sh_flags) & SHF_ALLOC) {
+            // smaller contents are zero padded, the section keeps its size
+            data.resize(size);
+            plan.writes.emplace_back(offset, std::move(data));
+            continue;
+        }
+
+        Elf64_Xword newSize = data.size();
+
+        if (newSize <= size)
+            plan.writes.emplace_back(offset, std::move(data));
+        else
+            offset = append(std::move(data), std::max<Elf64_Xword>(load<Endian>(shdr.sh_addralign), 1));
+
+        store<Endian>(shdr.sh_offset, offset);
+        store<Endian>(shdr.sh_size, newSize);
+        tableChanged = true;
+    }
+
+    if (!mAdditions.empty()) {
+        Elf64_Word strIndex = header->sectionStrIndex();
+
+        if (!count)
+            return tl::unexpected(make_error_code(std::errc::not_supported));
+
+        if (strIndex == SHN_UNDEF || strIndex >= count)
+            return tl::unexpected(make_error_code(Error::INVALID_ELF_HEADER));
+
+        Elf64_Off offset = load<Endian>(shdrs[strIndex].sh_offset);
+        Elf64_Xword size = load<Endian>(shdrs[strIndex].sh_size);
+
+        if (offset > length || size > length - offset)
+            return tl::unexpected(make_error_code(Error::INVALID_ELF_HEADER));
+
+        std::vector<std::byte> strings(buffer + offset, buffer + offset + size);
+
+        auto replaced = mReplacements.find(strIndex);
+
+        if (replaced != mReplacements.end())
+            strings = replaced->second;
+
+        for (const auto &addition: mAdditions) {
+            Shdr shdr = {};
+
+            store<Endian>(shdr.sh_name, strings.size());
+            store<Endian>(shdr.sh_type, addition.type);
+            store<Endian>(shdr.sh_flags, addition.flags);
+            store<Endian>(shdr.sh_size, addition.data.size());
+            store<Endian>(shdr.sh_addralign, addition.addressAlign);
+            store<Endian>(shdr.sh_offset, append(addition.data, addition.addressAlign));
+
+            strings.insert(strings.end(), (const std::byte *) addition.name.data(),
+                           (const std::byte *) addition.name.data() + addition.name.size());
+            strings.push_back(std::byte{0});
+
+            shdrs.push_back(shdr);
+        }
+
+        // the grown name table no longer fits its old place
+        store<Endian>(shdrs[strIndex].sh_size, strings.size());
+        store<Endian>(shdrs[strIndex].sh_offset, append(std::move(strings), 1));
+
+        tableChanged = true;
+    }
+
+    for (const auto &patch: mPatches)
+        plan.writes.push_back(patch);
+
+    if (mEntry) {
+        store<Endian>(ehdr.e_entry, *mEntry);
+        headerChanged = true;
+    }
+
+    if (shdrs.size() != count) {
+        // counts past the reserved range escape into section 0
+        if (shdrs.size() >= SHN_LORESERVE) {
+            store<Endian>(ehdr.e_shnum, 0);
+            store<Endian>(shdrs[0].sh_size, shdrs.size());
+        } else {
+            store<Endian>(ehdr.e_shnum, shdrs.size());
+        }
+
+        std::vector<std::byte> table(shdrs.size() * sizeof(Shdr));
+        memcpy(table.data(), shdrs.data(), table.size());
+
+        store<Endian>(ehdr.e_shoff, append(std::move(table), alignof(Shdr)));
+
+        headerChanged = true;
+    } else if (tableChanged) {
+        std::vector<std::byte> table(count * sizeof(Shdr));
+        memcpy(table.data(), shdrs.data(), table.size());
+
+        plan.writes.emplace_back(tableOffset, std::move(table));
+    }
+
+    if (end > std::numeric_limits<decltype(Shdr::sh_offset)>::max())
+        return tl::unexpected(make_error_code(std::errc::file_too_large));
+
+    if (headerChanged)
+        plan.writes.emplace_back(0, bytes(ehdr));
+
+    plan.size = end;
+    return plan;
+}
+
+tl::expected<elf::Writer, std::error_code> elf::openWriter(const std::filesystem::path &path) {
+    auto reader = openFile(path);
+
+    if (!reader)
+        return tl::unexpected(reader.error());
+
+    return Writer(std::move(*reader), path);
+}
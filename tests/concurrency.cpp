@@ -0,0 +1,69 @@
+#include <elf/reader.h>
+#include <elf/symbol.h>
+#include <atomic>
+#include <thread>
+#include <cstdio>
+
+constexpr auto THREADS = 8;
+constexpr auto ROUNDS = 16;
+
+// N threads race on the lazily built tables of one shared reader, run under -fsanitize=thread to catch data races
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <elf>\n", argv[0]);
+        return 2;
+    }
+
+    auto reader = elf::openFile(argv[1]);
+
+    if (!reader) {
+        fprintf(stderr, "open %s failed: %s\n", argv[1], reader.error().message().c_str());
+        return 1;
+    }
+
+    std::atomic<bool> start = false;
+    std::atomic<size_t> failures = 0;
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < THREADS; i++) {
+        threads.emplace_back([&, copy = *reader]() {
+            while (!start)
+                std::this_thread::yield();
+
+            for (size_t round = 0; round < ROUNDS; round++) {
+                const auto &sections = copy.sections();
+                const auto &segments = copy.segments();
+
+                if (sections.size() != copy.header()->sectionNum() || segments.size() != copy.header()->segmentNum())
+                    failures++;
+
+                for (const auto &section: sections) {
+                    if (section->name().empty() || (section->type() != SHT_SYMTAB && section->type() != SHT_DYNSYM))
+                        continue;
+
+                    if (copy.section(section->name()) != section)
+                        failures++;
+
+                    elf::SymbolTable table(copy, section);
+                    size_t named = 0;
+
+                    for (const auto &symbol: table.views())
+                        named += !symbol.name.empty();
+
+                    for (auto it = table.begin(); it != table.end(); ++it)
+                        named -= !(*it)->name().empty();
+
+                    if (named)
+                        failures++;
+                }
+            }
+        });
+    }
+
+    start = true;
+
+    for (auto &thread: threads)
+        thread.join();
+
+    return failures ? 1 : 0;
+}
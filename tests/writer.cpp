@@ -0,0 +1,169 @@
+#include <elf/writer.h>
+#include <elf/dynamic.h>
+#include <elf/note.h>
+#include <cstring>
+#include <cstdio>
+#include <unistd.h>
+
+constexpr auto NOTE_TYPE = 0x1234;
+constexpr auto GROWTH = 4096;
+
+static size_t failures = 0;
+
+static void expect(bool condition, const char *path, const char *what) {
+    if (condition)
+        return;
+
+    fprintf(stderr, "%s: %s\n", path, what);
+    failures++;
+}
+
+static std::vector<std::byte> bytes(std::string_view text) {
+    auto data = (const std::byte *) text.data();
+    return {data, data + text.size()};
+}
+
+static std::vector<std::byte> contents(const std::shared_ptr<elf::ISection> &section) {
+    return {section->data(), section->data() + section->size()};
+}
+
+static std::optional<Elf64_Xword> find(const elf::Reader &reader, Elf64_Sxword tag) {
+    auto section = reader.section(".dynamic");
+
+    if (!section)
+        return std::nullopt;
+
+    for (const auto &entry: elf::DynamicTable(reader, section)) {
+        if (entry->tag() == DT_NULL)
+            break;
+
+        if (entry->tag() == tag)
+            return entry->value();
+    }
+
+    return std::nullopt;
+}
+
+// reads an edited copy back the way readelf would, everything the original had must still be where it was
+static void verify(const elf::Reader &original, const std::filesystem::path &path, const std::vector<std::byte> &comment) {
+    auto reader = elf::openFile(path);
+
+    if (!reader) {
+        fprintf(stderr, "open %s failed: %s\n", path.c_str(), reader.error().message().c_str());
+        failures++;
+        return;
+    }
+
+    auto name = path.c_str();
+    const auto &sections = original.sections();
+
+    expect(reader->sections().size() == sections.size() + 2, name, "section count");
+    expect(reader->segments().size() == original.segments().size(), name, "segment count");
+
+    for (const auto &section: sections) {
+        if (section->name().empty() || section->name() == ".comment" || section->name() == ".shstrtab")
+            continue;
+
+        auto copy = reader->section(section->name());
+
+        if (!copy) {
+            expect(false, name, "original section missing");
+            continue;
+        }
+
+        expect(copy->type() == section->type() && copy->size() == section->size(), name, "original section header");
+
+        if (section->flags() & SHF_ALLOC)
+            expect(copy->address() == section->address() && copy->offset() == section->offset(), name, "allocated section moved");
+
+        if (section->type() != SHT_NOBITS && section->name() != ".dynamic")
+            expect(contents(copy) == contents(section), name, "original section contents");
+    }
+
+    auto grown = reader->section(".comment");
+    expect(grown && contents(grown) == comment, name, ".comment contents");
+
+    auto added = reader->section(".elf.cpp.test");
+    expect(added && added->type() == SHT_PROGBITS && contents(added) == bytes("added"), name, "added section");
+
+    auto note = reader->section(".note.elf.cpp");
+    expect(note && note->type() == SHT_NOTE, name, "note section");
+
+    if (note) {
+        size_t count = 0;
+
+        for (const auto &entry: elf::NoteTable(*reader, note)) {
+            auto descriptor = bytes("descriptor");
+
+            expect(entry->name() == "elf.cpp" && entry->type() == NOTE_TYPE, name, "note header");
+            expect(
+                    entry->descriptorSize() == descriptor.size() &&
+                    !memcmp(entry->descriptor(), descriptor.data(), descriptor.size()),
+                    name,
+                    "note descriptor"
+            );
+
+            count++;
+        }
+
+        expect(count == 1, name, "note count");
+    }
+
+    expect(find(*reader, DT_GNU_PRELINKED) == 1, name, "first dynamic tag");
+    expect(find(*reader, DT_CHECKSUM) == 2, name, "second dynamic tag");
+    expect(find(*reader, DT_NEEDED) == find(original, DT_NEEDED), name, "existing dynamic tag");
+}
+
+// edits a copy of a dynamically linked executable both into a new file and in place
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <elf>\n", argv[0]);
+        return 2;
+    }
+
+    auto directory = std::filesystem::temp_directory_path() / ("elf-cpp-writer-" + std::to_string(getpid()));
+    auto source = directory / "source";
+    auto target = directory / "target";
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+
+    if (!ec)
+        std::filesystem::copy_file(argv[1], source, ec);
+
+    if (ec) {
+        fprintf(stderr, "copy %s failed: %s\n", argv[1], ec.message().c_str());
+        return 1;
+    }
+
+    auto original = elf::openFile(argv[1]);
+    auto writer = elf::openWriter(source);
+
+    if (!original || !writer) {
+        fprintf(stderr, "open %s failed\n", argv[1]);
+        return 1;
+    }
+
+    auto comment = bytes("comment");
+    comment.resize(original->section(".comment")->size() + GROWTH, std::byte{'x'});
+
+    expect(!writer->replace(".comment", comment), argv[1], "replace .comment");
+    expect(!writer->addSection(".elf.cpp.test", SHT_PROGBITS, bytes("added")), argv[1], "add section");
+    expect(!writer->addNote(".note.elf.cpp", "elf.cpp", NOTE_TYPE, bytes("descriptor")), argv[1], "add note");
+    expect(!writer->dynamic(DT_GNU_PRELINKED, 1), argv[1], "add first dynamic tag");
+    expect(!writer->dynamic(DT_CHECKSUM, 2), argv[1], "add second dynamic tag");
+
+    // a copy leaves the source alone, an update rewrites it
+    expect(!writer->write(target), target.c_str(), "write");
+    verify(*original, target, comment);
+
+    auto unchanged = elf::openFile(source);
+    expect(unchanged && unchanged->section(".comment")->size() == original->section(".comment")->size(), source.c_str(), "written source");
+
+    expect(!writer->update(), source.c_str(), "update");
+    verify(*original, source, comment);
+
+    std::filesystem::remove_all(directory, ec);
+
+    return failures ? 1 : 0;
+}